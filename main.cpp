@@ -1,8 +1,23 @@
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <vector>
+#include <map>
 #include <algorithm>
 #include <cmath>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+#include <limits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 
 // ===================================
@@ -16,6 +31,7 @@ constexpr float PI = 3.14f;
 
 class Pod;
 class PodStrategy;
+class TurnDeadline;
 
 // ===================================
 // ==== Utility classes
@@ -118,6 +134,45 @@ public:
 	}
 };
 
+/**
+* Small and fast xorshift random generator, its sequence only depends on the seed whatever the standard library is
+*/
+class Random
+{
+private:
+
+	uint64_t _mState;
+
+public:
+
+	explicit Random(uint64_t aSeed = 0) :
+		_mState(aSeed != 0 ? aSeed : 0x9E3779B97F4A7C15ull)
+	{
+
+	}
+
+	uint64_t Next()
+	{
+		_mState ^= _mState >> 12;
+		_mState ^= _mState << 25;
+		_mState ^= _mState >> 27;
+		return _mState * 0x2545F4914F6CDD1Dull;
+	}
+
+	// Uniform integer in [aMin, aMax]
+	int Range(int aMin, int aMax)
+	{
+		const uint64_t span = static_cast<uint64_t>(aMax - aMin) + 1;
+		return aMin + static_cast<int>(((Next() >> 32) * span) >> 32);
+	}
+
+	// Uniform float in [0, 1)
+	float Float()
+	{
+		return (Next() >> 40) * (1.0f / 16777216.0f);
+	}
+};
+
 /**
 * Simulation result is use as computation result for Pod strategies and encapsulate all data needed for the ouput
 */
@@ -282,11 +337,23 @@ public:
 		std::cin >> checkpointCount; std::cin.ignore();
 
 		// Reading checkpointCount follow lines for checkpoints
+		std::vector<Vector2<int>> positions;
 		for (size_t i = 0; i < checkpointCount; i++)
 		{
 			int checkpointX, checkpointY;
 			std::cin >> checkpointX >> checkpointY; std::cin.ignore();
-			_mCheckpoints.push_back(Checkpoint({ checkpointX, checkpointY }, 0, 0));
+			positions.push_back({ checkpointX, checkpointY });
+		}
+
+		Build(positions);
+	}
+
+	void Build(const std::vector<Vector2<int>>& aPositions)
+	{
+		_mCheckpoints.clear();
+		for (const Vector2<int>& position : aPositions)
+		{
+			_mCheckpoints.push_back(Checkpoint(position, 0, 0));
 		}
 
 		AssignBestBoostIndex();
@@ -294,6 +361,204 @@ public:
 };
 
 
+// ===================================
+// ==== Simulation
+// ===================================
+
+/**
+* Fixed-point helpers used by the simulator. The referee rounds positions and truncates speeds at the end of each turn,
+* working on integers holding FractionBits bits of fraction reproduce it without any round trip through float
+*/
+class FixedPoint
+{
+public:
+
+	static constexpr int FractionBits = 20;
+	static constexpr int64_t One = int64_t(1) << FractionBits;
+	static constexpr int64_t Half = One / 2;
+
+	static int64_t FromInt(int aValue) { return aValue * One; }
+
+	// Round half up, same as Math.round used by the referee on positions
+	static int Round(int64_t aValue) { return static_cast<int>((aValue + Half) >> FractionBits); }
+
+	// Truncate toward zero, same as the (int) cast used by the referee on speeds
+	static int Truncate(int64_t aValue) { return static_cast<int>(aValue / One); }
+};
+
+/**
+* Cosine and sine of every integer degree in fixed-point, built once so the simulator never calls cos or sin
+* The table keeps more fraction bits than FixedPoint, so that the error stays far below the referee rounding even once
+* multiplied by the boost thrust
+*
+* Known divergences : the table is exact where cos or sin is rational (0, 30, 60, 90... degrees) but the referee double
+* cos and sin are not, e.g. sin(180) is 1.2e-16 there. When the speed then lands exactly on an integer, the referee
+* truncation or rounding falls on the other side : a pod going up at -20 ends at -16 after friction for the referee
+* and at -17 here. A few more come from collision times computed from the rounded fixed-point positions.
+* --check-simulator measures them, about 0.08% of the turns of random games, a third of them on a collision.
+* They are not worth the cost of double trigonometry, the bot reads the real state back every turn
+*/
+class FixedTrigonometry
+{
+private:
+
+	int64_t _mCos[360];
+	int64_t _mSin[360];
+
+	FixedTrigonometry()
+	{
+		const double pi = std::acos(-1.0);
+		const double one = static_cast<double>(int64_t(1) << FractionBits);
+		for (int angle = 0; angle < 360; angle++)
+		{
+			_mCos[angle] = std::llround(std::cos(angle * pi / 180.0) * one);
+			_mSin[angle] = std::llround(std::sin(angle * pi / 180.0) * one);
+		}
+	}
+
+public:
+
+	static constexpr int FractionBits = 40;
+
+	static const FixedTrigonometry& Instance()
+	{
+		static const FixedTrigonometry instance;
+		return instance;
+	}
+
+	static int NormalizeAngle(int aAngle)
+	{
+		aAngle %= 360;
+		return (aAngle < 0) ? (aAngle + 360) : (aAngle);
+	}
+
+	// aLength * cos(aAngle) converted to FixedPoint
+	int64_t CosScaled(int aAngle, int aLength) const { return Rescale(_mCos[aAngle] * aLength); }
+	// aLength * sin(aAngle) converted to FixedPoint
+	int64_t SinScaled(int aAngle, int aLength) const { return Rescale(_mSin[aAngle] * aLength); }
+
+private:
+
+	static int64_t Rescale(int64_t aValue)
+	{
+		constexpr int shift = FractionBits - FixedPoint::FractionBits;
+		return (aValue + (int64_t(1) << (shift - 1))) >> shift;
+	}
+};
+
+/**
+* Compact physical state of a pod, holding exactly the integers the referee keeps between two turns
+* Positions and speeds fit in 16 bits as pods never go further than a few thousand units outside the 16000x9000 map,
+* which allow the 4 pods of a game to fit in a single cache line
+*/
+struct alignas(16) PodState
+{
+	int16_t X;
+	int16_t Y;
+	int16_t VX;
+	int16_t VY;
+	int16_t Angle;
+	uint8_t NextCheckpointIndex;
+	uint8_t ShieldCooldown;
+	uint16_t CheckpointsPassed;
+	uint8_t BoostAvailable;
+	uint8_t Shielded;
+};
+
+static_assert(sizeof(PodState) == 16, "PodState should stay 16 bytes");
+static_assert(std::is_trivially_copyable<PodState>::value, "PodState should be trivially copyable");
+
+/**
+* One turn order for a pod as the simulator consume it, a rotation clamped to [-18, 18] degrees and a thrust in [0, 100]
+* Boost and Shield are encoded as special thrust values
+*/
+struct PodMove
+{
+	int16_t Rotation;
+	int16_t Thrust;
+
+	static constexpr int16_t Boost = -1;
+	static constexpr int16_t Shield = -2;
+};
+
+/**
+* Full state of a game between two turns : the 4 pods (ours first, then the opponent ones) with their progress counters
+* and the turns left to each player before timing out. Trivially copyable and kept within two cache lines, so that
+* searches can copy it freely
+*/
+struct alignas(64) GameState
+{
+	PodState Pods[4];
+	int16_t TimeLeft[2];
+	int16_t Turn;
+};
+
+static_assert(sizeof(GameState) == 128, "GameState should stay within two cache lines");
+static_assert(std::is_trivially_copyable<GameState>::value, "GameState should be trivially copyable");
+
+/**
+* Deterministic turn simulator following the referee rules : rotation, thrust, movement with elastic collisions, checkpoints
+* The movement is done in fixed-point, only the rare collision resolution uses double as the referee does
+*/
+class Simulator
+{
+private:
+
+	/**
+	* Position and speed of a pod during the turn, in fixed-point
+	*/
+	struct MovingPod
+	{
+		int64_t X;
+		int64_t Y;
+		int64_t VX;
+		int64_t VY;
+	};
+
+	int _mCheckpointCount;
+	Vector2<int> _mCheckpoints[8];
+
+	bool CollisionTime(const MovingPod& aPodA, const MovingPod& aPodB, int64_t aRemainingTime, int64_t& aTime) const;
+	void Bounce(MovingPod& aPodA, MovingPod& aPodB, bool aShieldedA, bool aShieldedB) const;
+	void Move(PodState& aPod, MovingPod& aMovingPod, int64_t aTime) const;
+
+public:
+
+	static constexpr int MaxCheckpoints = 8;
+	static constexpr int MaxPods = 4;
+	static constexpr int MaxRotation = 18;
+	static constexpr int MaxThrust = 100;
+	static constexpr int BoostThrust = 650;
+	static constexpr int ShieldCooldown = 3;
+	static constexpr int ShieldMass = 10;
+	static constexpr int PodRadius = 400;
+	static constexpr int CheckpointRadius = 600;
+	static constexpr int MinImpulse = 120;
+	static constexpr int FrictionPercent = 85;
+	static constexpr int Timeout = 100;
+
+	Simulator() :
+		_mCheckpointCount(0)
+	{
+
+	}
+
+	explicit Simulator(const CheckpointManager& aCheckpointManager);
+
+	int NumberOfCheckpoint() const { return _mCheckpointCount; }
+	const Vector2<int>& CheckpointPosition(int aIndex) const { return _mCheckpoints[aIndex]; }
+
+	// Rotation to give to the pod in order to face aTarget, clamped as the referee would
+	static int RotationToward(const PodState& aPod, Vector2<int> aTarget);
+	// Point to output in order to make the referee apply aMove
+	static Vector2<int> TargetOf(const PodState& aPod, const PodMove& aMove);
+	// Full thrust toward the next checkpoint : the move searches predict for opponents, and their greedy start
+	PodMove StraightMove(const PodState& aPod) const;
+
+	void PlayTurn(PodState* aPods, const PodMove* aMoves, int aPodCount) const;
+	void PlayTurn(GameState& aState, const PodMove* aMoves) const;
+};
+
 /**
 * Like SimulationResult, provide an encapsulated class to regroup all informations that need to be use for computation of strategies
 */
@@ -331,6 +596,7 @@ private:
 	int _mNextCheckpointIndex;
 	int _mThrust;
 	int _mCurrentLap;
+	int _mCheckpointsPassed;
 	Vector2<int> _mSpeed;
 	int _mAngle;
 
@@ -355,6 +621,7 @@ public:
 		_mNextCheckpointIndex(0),
 		_mTarget({ 0,0 }),
 		_mCurrentLap(0),
+		_mCheckpointsPassed(0),
 		_mShieldUsed(false),
 		_mBoostUsed(false)
 	{
@@ -372,6 +639,7 @@ public:
 		_mNextCheckpointIndex(0),
 		_mTarget({ 0,0 }),
 		_mCurrentLap(0),
+		_mCheckpointsPassed(0),
 		_mShieldUsed(false),
 		_mBoostUsed(false)
 	{
@@ -386,11 +654,14 @@ public:
 	bool BoostUsed() const { return _mBoostUsed; }
 	bool ShieldUsed() const { return _mShieldUsed; }
 	int CurrentLap() const { return _mCurrentLap; }
+	int CheckpointsPassed() const { return _mCheckpointsPassed; }
 	int NextCheckpointIndex() const { return _mNextCheckpointIndex; }
 	int Angle() const { return _mAngle; }
 	const Vector2<int>& Speed() const { return _mSpeed; }
 	const Vector2<int>& Target() const { return _mTarget; }
 	int Thrust() const { return _mThrust; }
+	// Simulator view of the pod
+	PodState State() const;
 
 	// -- Setters
 	void SetTarget(const Vector2<int> aTarget) { _mTarget = aTarget; }
@@ -416,6 +687,10 @@ public:
 	void UpdateFromStandardInput();
 	std::string Compute(const SimulationEntry& aSimulationEntry);
 	void UpdateStrategy(PodStrategy& aStrategy);
+
+	void UpdateFromEstimation(const PodState& aState, int aCheckpointCount);
+	std::string Output(const PodState& aState, const PodMove& aMove);
+	PodMove LastMove(const PodState& aState) const;
 };
 
 /**
@@ -521,291 +796,3489 @@ public:
 	SimulationResult Compute(Pod& pod, const SimulationEntry& aSimulationEntry);
 };
 
-// ===================================
-// ==== Inline implementations
-// ===================================
+/**
+* Best racer action for a quantized state relative to the next checkpoint : speed along and across the way to it,
+* pod angle and angle of the following leg relative to it, distance to it. Built by simulating every action from the
+* center of each cell, states with a lateral speed to the right are mirrored to the left to halve the table.
+* Lookups interpolate between the 4 cells surrounding the pod angle and the distance
+*/
+class RacerLookupTable
+{
+public:
 
+	static constexpr int ForwardSpeedBins = 6;
+	static constexpr int LateralSpeedBins = 4;
+	static constexpr int AngleBins = 12;
+	static constexpr int LegAngleBins = 8;
+	static constexpr int DistanceBins = 6;
+	static constexpr int CellCount = ForwardSpeedBins * LateralSpeedBins * AngleBins * LegAngleBins * DistanceBins;
 
-// ==== Checkpoint ====
-float Checkpoint::Radius = 600.0f;
+	static constexpr int SimulatedTurns = 6;
+	static constexpr float LatenessPenalty = 1000.f;
+	static constexpr int LegLength = 5000;
 
-// ==== Pod ====
-int Pod::MaxThrust = 100;
+private:
 
-inline bool Pod::IsRacer() const
-{
-	return _mStrategy->IsRacer();
-}
+	struct Action
+	{
+		int8_t Rotation;
+		uint8_t Thrust;
+	};
 
-inline void Pod::UpdateFromStandardInput()
-{
-	int x, y, vx, vy, angle, nextCheckpointIndex;
-	std::cin >> x >> y >> vx >> vy >> angle >> nextCheckpointIndex; std::cin.ignore();
+	std::vector<Action> _mActions;
 
-	_mPosition = { x,y };
-	_mSpeed = { vx, vy };
-	_mAngle = angle;
-	if (nextCheckpointIndex != _mNextCheckpointIndex)
+	static int Index(int aForwardSpeed, int aLateralSpeed, int aAngle, int aLegAngle, int aDistance)
 	{
-		_mNextCheckpointIndex = nextCheckpointIndex;
-		if (nextCheckpointIndex == 0)
-		{
-			_mCurrentLap++;
-		}
+		return (((aForwardSpeed * LateralSpeedBins + aLateralSpeed) * AngleBins + aAngle) * LegAngleBins + aLegAngle) * DistanceBins + aDistance;
 	}
 
-	_mShieldUsed = false;
-	_mBoostUsed = false;
-	if (_mShieldCooldown > 0)
+	static float ForwardSpeedCenter(int aBin) { return -100.f + 200.f * aBin; }
+	static float LateralSpeedCenter(int aBin) { return 100.f + 200.f * aBin; }
+	static float AngleCenter(int aBin) { return -165.f + 30.f * aBin; }
+	static float LegAngleCenter(int aBin) { return -157.5f + 45.f * aBin; }
+	static float DistanceCenter(int aBin)
 	{
-		_mShieldCooldown--;
+		static const float centers[DistanceBins] = { 700.f, 1500.f, 2500.f, 4000.f, 6000.f, 9000.f };
+		return centers[aBin];
 	}
-}
 
-inline void Pod::UpdateStrategy(PodStrategy& aStrategy)
-{
-	_mStrategy = &aStrategy;
-}
+	Action Solve(const Simulator& aSimulator, int aForwardSpeed, int aLateralSpeed, int aAngle, int aDistance) const;
 
-inline std::string Pod::Compute(const SimulationEntry& aSimulationEntry)
-{
-	SimulationResult result = _mStrategy->Compute(*this, aSimulationEntry);
-	if (result.Boost)
-	{
-		std::cerr << "BOOST" << std::endl;
-		return std::to_string(result.X) + " " + std::to_string(result.Y) + " " + "BOOST";
-	}
-	if (result.Shield)
-	{
-		std::cerr << "SHIELD" << std::endl;
-		return std::to_string(result.X) + " " + std::to_string(result.Y) + " " + "SHIELD";
-	}
+public:
 
-	return std::to_string(result.X) + " " + std::to_string(result.Y) + " " + std::to_string(result.Thrust);
-}
+	bool Built() const { return _mActions.empty() == false; }
+	size_t SizeInBytes() const { return _mActions.size() * sizeof(Action); }
 
+	void Build();
+	// Rotation and thrust for aPod heading to aNextCheckpoint, then to aFollowingCheckpoint
+	void Lookup(const PodState& aPod, Vector2<int> aNextCheckpoint, Vector2<int> aFollowingCheckpoint, int& aRotation, int& aThrust) const;
+};
 
-// ==== Pod Strategy ====
-inline bool PodStrategy::Collision(const Pod& podA, const Pod& podB)
+/**
+* Racer strategy taking its angle and thrust from the RacerLookupTable, boosting on the best boost leg once aligned
+*/
+class LookupRacerPodStrategy : public RacerPodStrategy
 {
-	const Vector2<int> podANextPosition = podA.Position() + podA.Speed();
-	const Vector2<int> podBNextPosition = podB.Position() + podB.Speed();
-	bool collision = (podANextPosition.DistanceSqr(podBNextPosition) < ((2 * 420) * (2 * 420)));
+private:
 
-	return collision;
-}
+	const RacerLookupTable* _mTable;
 
-inline void PodStrategy::ComputeThrust(Pod& pod, const SimulationEntry& aSimulationEntry)
-{
-	Checkpoint podTargetCheckpoint = aSimulationEntry.checkpointManager[pod.NextCheckpointIndex()];
+public:
 
-	if (ShouldUseShield(pod, aSimulationEntry))
+	LookupRacerPodStrategy(const RacerLookupTable& aTable) :
+		RacerPodStrategy(),
+		_mTable(&aTable)
 	{
-		pod.RequestShield();
+
 	}
 
-	float actualAngle = ComputeAngle(pod, pod.Target());
-	float angleDifference = abs((int)(actualAngle - pod.Angle()));
+	SimulationResult Compute(Pod& pod, const SimulationEntry& aSimulationEntry);
+};
 
-	if (angleDifference < 2 && pod.Target().Distance(pod.Position()) > 650)
-	{
-		pod.SetThrust(pod.MaxThrust);
+/**
+* Beam search over the racer moves alone, opponents ignored : every state of the beam is expanded with rotations
+* -18/0/18 and a few thrusts, boost included while available, then the best Width ones by race progress are kept.
+* States dominated by another one of the same bucket (same area, heading and checkpoint count, behind it without
+* more speed toward the next checkpoint) are dropped first so that the beam doesn't fill with copies of one trajectory
+* Once the deadline expires the depth being expanded is dropped and the best node of the last complete one is played
+*/
+class BeamSearchRacer
+{
+public:
 
-		if (podTargetCheckpoint.IsBestBoostIndex())
-			pod.RequestBoost();
-	}
-	else
-	{
-		const Vector2<int> targetPosition = pod.Target();
-		// Try to minimize drifting
-		pod.SetTarget(targetPosition - (pod.Speed() * 3.f));
+	static constexpr int DefaultWidth = 500;
+	static constexpr int Depth = 16;
+	static constexpr int BucketSize = 250;
+	static constexpr int SpeedSectors = 8;
+	// Beam nodes expanded between two deadline checks, about 0.1ms of work
+	static constexpr int DeadlineCheckInterval = 64;
 
-		float distanceToTarget = targetPosition.Distance(pod.Position());
-		float distanceSlowdownFactor = std::clamp(distanceToTarget / (2.f * Checkpoint::Radius), 0.f, 1.f);
+private:
 
-		float angleToTarget = ComputeAngle(pod, pod.Target());
-		float angle = angleToTarget - pod.Angle();
-		float angleSlowdownFactor = 1.f - std::clamp(abs((int)angle) / 90.f, 0.f, 1.f);
+	struct Node
+	{
+		PodState Pod;
+		PodMove FirstMove;
+		float Progress;
+		float Speed;
+	};
+
+	int _mWidth;
+	std::vector<Node> _mBeam;
+	std::vector<Node> _mChildren;
+
+	// Open addressing over the children, a bucket is only valid when its stamp is the current one
+	std::vector<uint64_t> _mBucketKeys;
+	std::vector<uint32_t> _mBucketStamps;
+	std::vector<int> _mBucketNodes;
+	uint32_t _mStamp;
+
+	long long _mNodes;
+	int _mDepthReached;
+	float _mElapsed;
+
+	static uint64_t BucketKey(const PodState& aPod);
+	void Evaluate(const Simulator& aSimulator, Node& aNode) const;
+	void Insert(const Node& aNode);
 
-		pod.SetThrust(pod.MaxThrust * distanceSlowdownFactor * angleSlowdownFactor);
-	}
-}
+public:
 
-// ==== Standard Pod Strategy ====
+	explicit BeamSearchRacer(int aWidth = DefaultWidth);
 
-inline bool RacerPodStrategy::BeneficialCollision(const Pod& podA, const Pod& podB)
-{
-	// Dot product of two normalized vectors gives a value between -1 and 1
-	// 0 = Vectors are perpendicular
-	// 1 = Vectors are parallel (facing the same direction)
-	// -1 = Vectors are anti-parallel (facing the opposite direction)
-	// 
-	// 0.5 seems a reasonable value, meaning the pod will still be more or less pushed into the good direction
-	const Vector2<float> podADirection = (podA.Target() - podA.Position()).Normalize();
-	const Vector2<float> podBDirectionSmashingA = (podA.Position() - podB.Position()).Normalize();
-	std::cerr << podA.Position().X << " - " << podB.Position().X << std::endl;
-	std::cerr << "Direction X " << (podA.Position() - podB.Position()).X << std::endl;
-	float dot = podADirection.Dot(podBDirectionSmashingA);
-	return dot > 0.5f;
-}
+	int Width() const { return _mWidth; }
+	// Nodes simulated by the last search
+	long long Nodes() const { return _mNodes; }
+	// Complete depths of the last search, Depth unless the deadline stopped it
+	int DepthReached() const { return _mDepthReached; }
+	// Milliseconds spent by the last search
+	float Elapsed() const { return _mElapsed; }
 
-inline bool RacerPodStrategy::ShouldUseShield(Pod& pod, const SimulationEntry& aSimulationEntry)
+	// The first depth is always searched, even past aDeadline, so that there is a move to play
+	PodMove Search(const Simulator& aSimulator, const PodState& aRoot, const TurnDeadline& aDeadline);
+};
+
+/**
+* Racer strategy playing the first move of the best BeamSearchRacer sequence
+*/
+class BeamRacerPodStrategy : public RacerPodStrategy
 {
-	Pod& otherPod = (aSimulationEntry.myPods[0].IsRacer()) ? (aSimulationEntry.myPods[1]) : (aSimulationEntry.myPods[0]);
-	Pod& opponentPod1 = aSimulationEntry.opponentPods[0];
-	Pod& opponentPod2 = aSimulationEntry.opponentPods[1];
+private:
 
-	if (Collision(pod, otherPod))
-	{
-		if (BeneficialCollision(pod, otherPod))
-			return false;
+	BeamSearchRacer* _mSearch;
+	const TurnDeadline* _mDeadline;
 
-		//return true;
-		return true;
-	}
+public:
 
-	if (Collision(pod, opponentPod1))
+	BeamRacerPodStrategy(BeamSearchRacer& aSearch) :
+		RacerPodStrategy(),
+		_mSearch(&aSearch),
+		_mDeadline(nullptr)
 	{
-		if (BeneficialCollision(pod, opponentPod1))
-			return false;
 
-		return true;
 	}
 
-	if (Collision(pod, opponentPod2))
-	{
-		if (BeneficialCollision(pod, opponentPod2))
-			return false;
+	// Deadline of the turn being computed, the search is unlimited without one
+	void SetDeadline(const TurnDeadline* aDeadline) { _mDeadline = aDeadline; }
 
-		return true;
-	}
+	SimulationResult Compute(Pod& pod, const SimulationEntry& aSimulationEntry);
+};
 
-	return false;
-}
+// ===================================
+// ==== Turn scheduling
+// ===================================
 
-inline Vector2<int> RacerPodStrategy::ComputeTarget(Pod& pod, const SimulationEntry& aSimulationEntry)
+/**
+* Everything an engine needs to search a turn : the game state and the race description
+*/
+struct TurnContext
+{
+	GameState State;
+	const Simulator* TurnSimulator;
+	int Laps;
+};
+
+/**
+* Time limit given to an engine, engines are expected to poll it between two units of work and stop once it expired
+*/
+class TurnDeadline
+{
+private:
+
+	using Clock = std::chrono::steady_clock;
+
+	Clock::time_point _mStart;
+	Clock::time_point _mEnd;
+
+public:
+
+	TurnDeadline(Clock::time_point aStart, Clock::time_point aEnd) :
+		_mStart(aStart),
+		_mEnd(aEnd)
+	{
+
+	}
+
+	bool Expired() const { return Clock::now() >= _mEnd; }
+
+	// Milliseconds spent past the deadline, negative while it is not reached
+	float Overtime() const { return std::chrono::duration<float, std::milli>(Clock::now() - _mEnd).count(); }
+
+	// Fraction of the time already spent, from 0 to 1
+	float Progress() const
+	{
+		const float total = std::chrono::duration<float>(_mEnd - _mStart).count();
+		const float elapsed = std::chrono::duration<float>(Clock::now() - _mStart).count();
+		return (total > 0.f) ? (std::clamp(elapsed / total, 0.f, 1.f)) : (1.f);
+	}
+};
+
+/**
+* Best answer found so far for our two pods, engines submit to it every time they improve so that something
+* is always ready to be output when the deadline is reached
+*/
+class TurnAnswer
+{
+private:
+
+	bool _mAvailable;
+	float _mScore;
+	PodMove _mMoves[2];
+
+public:
+
+	TurnAnswer() :
+		_mAvailable(false),
+		_mScore(0.f),
+		_mMoves()
+	{
+
+	}
+
+	bool Available() const { return _mAvailable; }
+	float Score() const { return _mScore; }
+	const PodMove& Move(int aPodIndex) const { return _mMoves[aPodIndex]; }
+
+	void Submit(const PodMove& aFirstPodMove, const PodMove& aSecondPodMove, float aScore)
+	{
+		if (_mAvailable && aScore <= _mScore)
+			return;
+
+		_mAvailable = true;
+		_mScore = aScore;
+		_mMoves[0] = aFirstPodMove;
+		_mMoves[1] = aSecondPodMove;
+	}
+};
+
+/**
+* Abstract base class for engines computing our two pods moves within a deadline
+*/
+class TurnEngine
+{
+public:
+
+	virtual ~TurnEngine()
+	{
+
+	}
+
+	virtual const char* Name() const = 0;
+	virtual void Search(const TurnContext& aContext, const TurnDeadline& aDeadline, TurnAnswer& aAnswer) = 0;
+
+	// Search ahead on the predicted next turn from a background thread until aStop is set, the next Search call
+	// resumes from what was found. Return the number of candidates evaluated
+	virtual int Ponder(const TurnContext& /*aPredicted*/, const std::atomic<bool>& /*aStop*/)
+	{
+		return 0;
+	}
+};
+
+/**
+* Anytime search engine, hill climbing over sequences of moves for both our pods simulated against opponents heading
+* straight to their next checkpoint. The best sequence is kept from a turn to the next, shifted by one turn
+*/
+class MonteCarloSearchEngine : public TurnEngine
+{
+public:
+
+	static constexpr int Depth = 6;
+
+	struct Solution
+	{
+		PodMove Moves[Depth][2];
+		float Score;
+	};
+
+private:
+
+	Random _mRandom;
+	Solution _mBest;
+	bool _mHasBest;
+	// The best sequence has already been shifted to the turn being searched
+	bool _mPondered;
+
+	// States along the best solution, _mStates[depth] being the state before its depth-th turn
+	GameState _mStates[Depth + 1];
+
+	void BuildGreedySolution(const TurnContext& aContext, Solution& aSolution) const;
+	int Mutate(Solution& aSolution, float aAmplitude);
+	float Play(const TurnContext& aContext, const Solution& aSolution, int aDepth, GameState* aStates) const;
+	float EvaluateState(const TurnContext& aContext, const GameState& aState) const;
+	void ShiftBest(const TurnContext& aContext);
+
+public:
+
+	MonteCarloSearchEngine(uint64_t aSeed = 1) :
+		_mRandom(aSeed),
+		_mBest(),
+		_mHasBest(false),
+		_mPondered(false)
+	{
+
+	}
+
+	const char* Name() const { return "MonteCarlo"; }
+	void Search(const TurnContext& aContext, const TurnDeadline& aDeadline, TurnAnswer& aAnswer);
+	int Ponder(const TurnContext& aPredicted, const std::atomic<bool>& aStop);
+
+	// Steps of Search, for engines driving several searches themselves
+	const Solution& Best() const { return _mBest; }
+	// Start the turn from the greedy sequence or the last best one, whichever is better
+	void Prepare(const TurnContext& aContext);
+	// Try one mutation of the best sequence, return true if it improved
+	bool Improve(const TurnContext& aContext, float aAmplitude);
+	// Take aSolution as best sequence if it is better
+	void Adopt(const TurnContext& aContext, const Solution& aSolution);
+};
+
+/**
+* Rendezvous point for a fixed number of threads, reusable from a round to the next
+*/
+class ThreadBarrier
+{
+private:
+
+	std::mutex _mMutex;
+	std::condition_variable _mCondition;
+	int _mCount;
+	int _mWaiting;
+	int _mGeneration;
+
+public:
+
+	explicit ThreadBarrier(int aCount) :
+		_mCount(aCount),
+		_mWaiting(0),
+		_mGeneration(0)
+	{
+
+	}
+
+	void Wait()
+	{
+		std::unique_lock<std::mutex> lock(_mMutex);
+		const int generation = _mGeneration;
+		if (++_mWaiting == _mCount)
+		{
+			_mWaiting = 0;
+			_mGeneration++;
+			_mCondition.notify_all();
+			return;
+		}
+		_mCondition.wait(lock, [&]() { return _mGeneration != generation; });
+	}
+};
+
+/**
+* Root parallelism over Monte Carlo searches : each thread climbs its own sequence from its own seed, at the end of
+* every epoch they meet and each one takes its neighbour best sequence if better, in a ring so that good sequences
+* spread without collapsing every thread onto the same one. Best of all threads is output.
+* In deterministic mode epochs and turns are a fixed number of candidates instead of a time, so that a game can be
+* replayed identically whatever the machine load
+*/
+class ParallelSearchEngine : public TurnEngine
+{
+public:
+
+	static constexpr int ExchangeInterval = 5;
+	static constexpr int ExchangeCandidates = 2000;
+	// Candidates between two deadline checks in deterministic mode
+	static constexpr int DeadlineCheckInterval = 16;
+
+private:
+
+	std::vector<MonteCarloSearchEngine> _mWorkers;
+	int _mDeterministicCandidates;
+	long long _mCandidates;
+
+	// Published best sequences, one set per epoch parity so that publishing the next never overwrites one being read
+	std::vector<MonteCarloSearchEngine::Solution> _mExchange[2];
+	// First epoch after which every thread stops, a thread already in the next epoch may lower it meanwhile
+	std::atomic<int> _mLastEpoch;
+	std::atomic<long long> _mEpochCandidates;
+	// Set when the deadline stopped a deterministic search before its candidates were all evaluated
+	std::atomic<bool> _mDeadlineCut;
+
+	void FinishAt(int aEpoch);
+	void Run(int aWorker, const TurnContext& aContext, const TurnDeadline& aDeadline, ThreadBarrier& aBarrier);
+
+public:
+
+	// aDeterministicCandidates is the number of candidates per thread and per turn, 0 to search until the deadline
+	ParallelSearchEngine(int aThreads = 1, int aDeterministicCandidates = 0) :
+		_mDeterministicCandidates(aDeterministicCandidates),
+		_mCandidates(0),
+		_mLastEpoch(std::numeric_limits<int>::max()),
+		_mEpochCandidates(0),
+		_mDeadlineCut(false)
+	{
+		const int threads = std::max(1, aThreads);
+		for (int i = 0; i < threads; i++)
+		{
+			_mWorkers.emplace_back(1 + i * 0x9E3779B97F4A7C15ull);
+		}
+		_mExchange[0].resize(threads);
+		_mExchange[1].resize(threads);
+	}
+
+	const char* Name() const { return "ParallelMonteCarlo"; }
+	int Threads() const { return static_cast<int>(_mWorkers.size()); }
+	// Candidates evaluated by all threads during the last search
+	long long Candidates() const { return _mCandidates; }
+
+	void Search(const TurnContext& aContext, const TurnDeadline& aDeadline, TurnAnswer& aAnswer);
+	int Ponder(const TurnContext& aPredicted, const std::atomic<bool>& aStop);
+};
+
+/**
+* Start the clock when the turn input arrive, hand the deadline to the engine and keep track of the time left
+* when our output is sent. The safety margin is kept aside from the referee limit for parsing, output and scheduling jitter
+*/
+class TurnScheduler
+{
+private:
+
+	using Clock = std::chrono::steady_clock;
+
+	int _mSafetyMargin;
+	int _mTurnBudget;
+	int _mTurn;
+	bool _mTurnStarted;
+	Clock::time_point _mTurnStart;
+
+	int _mLateReturns;
+	int _mFallbacks;
+	int _mOverruns;
+	float _mMinMargin;
+	float _mTotalMargin;
+
+	int TurnBudget() const { return (_mTurn == 0) ? (FirstTurnBudget) : (_mTurnBudget); }
+
+public:
+
+	static constexpr int FirstTurnBudget = 1000;
+	static constexpr int NextTurnsBudget = 75;
+	static constexpr int DefaultSafetyMargin = 10;
+	// An engine checks the deadline between two units of work, each well under this many milliseconds
+	static constexpr float LateTolerance = 1.f;
+
+	TurnScheduler(int aSafetyMargin = DefaultSafetyMargin, int aTurnBudget = NextTurnsBudget) :
+		_mSafetyMargin(aSafetyMargin),
+		_mTurnBudget(aTurnBudget),
+		_mTurn(0),
+		_mTurnStarted(false),
+		_mLateReturns(0),
+		_mFallbacks(0),
+		_mOverruns(0),
+		_mMinMargin(static_cast<float>(FirstTurnBudget)),
+		_mTotalMargin(0.f)
+	{
+
+	}
+
+	int Turn() const { return _mTurn; }
+
+	// Return false once the input is closed
+	bool WaitForInput(std::istream& aInput = std::cin);
+	TurnDeadline Deadline() const;
+	void Play(TurnEngine* aEngine, const TurnContext& aContext, TurnAnswer& aAnswer);
+	void EndTurn(bool aEngineAnswered);
+};
+
+/**
+* Keep the engine searching while the referee and the opponent play : once our output is sent, the next state is
+* predicted from our moves and opponents heading to their checkpoint, and the engine ponders on it from a background
+* thread. The thread owns the engine until the next input arrives, stopping it is a flag the search polls between
+* two candidates so the handoff doesn't delay the turn. Only useful with a spare core, otherwise it takes the time
+* of the opponent and of our own parsing
+*/
+class Ponderer
+{
+private:
+
+	using Clock = std::chrono::steady_clock;
+
+	std::thread _mThread;
+	std::atomic<bool> _mStop;
+	std::atomic<int> _mCandidates;
+	TurnContext _mPredicted;
+	Clock::time_point _mStart;
+	float _mLastTime;
+	bool _mStopped;
+
+	int _mTurns;
+	int _mHits;
+	int _mOwnHits;
+	float _mTotalTime;
+	long long _mTotalCandidates;
+
+public:
+
+	Ponderer() :
+		_mStop(false),
+		_mCandidates(0),
+		_mPredicted(),
+		_mLastTime(0.f),
+		_mStopped(false),
+		_mTurns(0),
+		_mHits(0),
+		_mOwnHits(0),
+		_mTotalTime(0.f),
+		_mTotalCandidates(0)
+	{
+
+	}
+
+	~Ponderer()
+	{
+		Stop();
+	}
+
+	Ponderer(const Ponderer&) = delete;
+	Ponderer& operator=(const Ponderer&) = delete;
+
+	bool Running() const { return _mThread.joinable(); }
+
+	void Start(TurnEngine* aEngine, const TurnContext& aContext, const PodMove& aFirstPodMove, const PodMove& aSecondPodMove);
+	// Give the engine back to the calling thread
+	void Stop();
+	// Check the last prediction against the real state and log pondering stats
+	void Report(const TurnContext& aActual);
+};
+
+// ===================================
+// ==== World estimation
+// ===================================
+
+/**
+* Maintain the full state of the 4 pods from a turn to the next, including what the referee doesn't tell :
+* checkpoints passed, boost availability and shield cooldown. Opponent orders are inferred by replaying the last turn
+* under each plausible order and keeping the one explaining best the observed positions and speeds, which also covers
+* collisions where a shield changes the response
+*/
+class WorldEstimator
+{
+private:
+
+	const Simulator* _mSimulator;
+	bool _mInitialized;
+	GameState _mState;
+	PodMove _mLastMoves[2];
+	int _mOpponentShields[2];
+	int _mOpponentBoostTurn[2];
+
+	PodState Observe(const Pod& aPod, const PodState& aPrevious) const;
+	int EstimateThrust(const PodState& aPrevious, const PodState& aObserved) const;
+	int BuildCandidates(const PodState& aPrevious, const PodState& aObserved, PodMove* aCandidates) const;
+
+public:
+
+	explicit WorldEstimator(const Simulator& aSimulator) :
+		_mSimulator(&aSimulator),
+		_mInitialized(false),
+		_mState(),
+		_mLastMoves(),
+		_mOpponentShields{ 0, 0 },
+		_mOpponentBoostTurn{ -1, -1 }
+	{
+
+	}
+
+	const GameState& State() const { return _mState; }
+	int OpponentShields(int aOpponent) const { return _mOpponentShields[aOpponent]; }
+	int OpponentBoostTurn(int aOpponent) const { return _mOpponentBoostTurn[aOpponent]; }
+
+	void RecordMoves(const PodMove& aFirstPodMove, const PodMove& aSecondPodMove);
+	void Update(std::vector<Pod>& aMyPods, std::vector<Pod>& aOpponentPods);
+	void FillContext(TurnContext& aContext) const;
+};
+
+// ===================================
+// ==== Self-play
+// ===================================
+
+enum class MapCategory
+{
+	// No sharp turn nor long straight line
+	Easy,
+	// At least one checkpoint where the race turns back
+	Hairpin,
+	// At least one leg long enough to be worth a boost
+	LongLeg
+};
+
+/**
+* Random race following the game rules : 3 to 8 checkpoints whole inside the 16000x9000 field, at least MinSeparation
+* from each other. A given seed always gives the same maps
+*/
+class MapGenerator
+{
+public:
+
+	static constexpr int Width = 16000;
+	static constexpr int Height = 9000;
+	static constexpr int MinCheckpoints = 3;
+	static constexpr int MaxCheckpoints = Simulator::MaxCheckpoints;
+	static constexpr int MinSeparation = 2400;
+	static constexpr int Laps = 3;
+
+	// Turn at a checkpoint, in degrees, from which it is a hairpin
+	static constexpr int HairpinTurn = 135;
+	static constexpr int LongLegLength = 8000;
+
+private:
+
+	Random _mRandom;
+
+public:
+
+	explicit MapGenerator(uint64_t aSeed) :
+		_mRandom(aSeed)
+	{
+
+	}
+
+	void Generate(std::vector<Vector2<int>>& aCheckpoints, int& aLaps);
+
+	// Hairpin first, then long leg, a hairpin map with a long leg is a hairpin map
+	static MapCategory Classify(const std::vector<Vector2<int>>& aCheckpoints);
+	static const char* CategoryName(MapCategory aCategory);
+};
+
+/**
+* Fixed list of maps all benchmarks and comparisons are measured on, categories alternate so that any range of maps
+* is balanced. Any change to the generator or to the corpus changes results, Version must be bumped with it
+*/
+class MapCorpus
+{
+public:
+
+	static constexpr int Version = 1;
+	static constexpr int CategoryCount = 3;
+	static constexpr int MapsPerCategory = 1000;
+	static constexpr int Size = CategoryCount * MapsPerCategory;
+
+	static MapCategory Category(int aIndex) { return static_cast<MapCategory>(aIndex % CategoryCount); }
+	static void Map(int aIndex, std::vector<Vector2<int>>& aCheckpoints, int& aLaps);
+
+	// Print maps statistics by category and a checksum of the whole corpus, to check two builds use the same maps
+	static void Report(std::ostream& aOutput);
+};
+
+/**
+* Bot build running in a child process, talking the referee protocol through pipes
+*/
+class BotProcess
+{
+private:
+
+	pid_t _mPid;
+	int _mInput;
+	int _mOutput;
+	std::string _mBuffer;
+
+public:
+
+	explicit BotProcess(const std::string& aCommand);
+	~BotProcess();
+
+	BotProcess(const BotProcess&) = delete;
+	BotProcess& operator=(const BotProcess&) = delete;
+
+	bool Send(const std::string& aText);
+	// Read a line of the bot output, fails when the bot exited or stayed silent longer than aTimeout milliseconds
+	bool Receive(std::string& aLine, int aTimeout);
+};
+
+/**
+* Local referee playing a full game between two bot processes with the simulator
+*/
+class LocalReferee
+{
+private:
+
+	CheckpointManager _mCheckpointManager;
+	Simulator _mSimulator;
+	int _mLaps;
+	int _mTimeTolerance;
+
+	// aTimedOut is set when the bot gave no answer before aDeadline
+	bool ReadMoves(BotProcess& aBot, std::chrono::steady_clock::time_point aDeadline, const GameState& aState, int aPlayer,
+		PodMove* aMoves, bool aFirstTurn, GameState& aNextState, bool& aTimedOut) const;
+
+public:
+
+	static constexpr int MaxTurns = 1000;
+	// Milliseconds allowed past the platform turn budgets, for pipes and process scheduling
+	static constexpr int DefaultTimeTolerance = 5;
+
+	LocalReferee(const std::vector<Vector2<int>>& aCheckpoints, int aLaps, int aTimeTolerance = DefaultTimeTolerance);
+
+	// State of the first turn on the map of aSimulator
+	static GameState StartState(const Simulator& aSimulator);
+
+	// Return the winning player, 0 for aFirstCommand, 1 for aSecondCommand, or -1 on draw
+	// As on the platform, a bot answering after the turn budget loses, aFirstTimedOut and aSecondTimedOut tell which one did
+	int Play(const std::string& aFirstCommand, const std::string& aSecondCommand, bool& aFirstTimedOut, bool& aSecondTimedOut) const;
+};
+
+/**
+* Sequential probability ratio test on game results, using the normal approximation of the score
+* H0 : B is elo0 better than A, H1 : B is elo1 better than A
+* Games come by pair on the same map with sides swapped, and the two games of a pair are far from independent : the
+* map decides a lot. The test is done on the pentanomial distribution of pair scores (0, 0.5, 1, 1.5 or 2 points for B),
+* whose variance takes that correlation into account
+*/
+class SequentialProbabilityRatioTest
+{
+private:
+
+	double _mElo0;
+	double _mElo1;
+	double _mAlpha;
+	double _mBeta;
+	int _mWins;
+	int _mDraws;
+	int _mLosses;
+	// Number of pairs by half points scored by B, from 0 to 4
+	int _mPairs[5];
+	// Games lost on time by A and by B
+	int _mTimeouts[2];
+
+	static double ExpectedScore(double aElo) { return 1.0 / (1.0 + std::pow(10.0, -aElo / 400.0)); }
+
+	// Mean and variance of the score of B per game, measured pair by pair
+	void PairScore(double& aMean, double& aVariance) const;
+
+public:
+
+	SequentialProbabilityRatioTest(double aElo0, double aElo1, double aAlpha, double aBeta) :
+		_mElo0(aElo0),
+		_mElo1(aElo1),
+		_mAlpha(aAlpha),
+		_mBeta(aBeta),
+		_mWins(0),
+		_mDraws(0),
+		_mLosses(0),
+		_mPairs(),
+		_mTimeouts()
+	{
+
+	}
+
+	int Games() const { return _mWins + _mDraws + _mLosses; }
+	int Pairs() const { return Games() / 2; }
+
+	double LowerBound() const { return std::log(_mBeta / (1.0 - _mAlpha)); }
+	double UpperBound() const { return std::log((1.0 - _mBeta) / _mAlpha); }
+
+	// Results of both games of a pair, 1 when B won, -1 when A won, 0 on draw
+	void AddPair(int aFirstResult, int aSecondResult);
+	void AddTimeouts(bool aTimedOutA, bool aTimedOutB) { _mTimeouts[0] += aTimedOutA; _mTimeouts[1] += aTimedOutB; }
+	double LogLikelihoodRatio() const;
+	// 1 when H1 is accepted, -1 when H0 is accepted, 0 while undecided
+	int Decision() const;
+	void Report(std::ostream& aOutput) const;
+};
+
+/**
+* Everything a comparison run needs, see --help
+*/
+struct SprtConfiguration
+{
+	std::string CommandA;
+	std::string CommandB;
+	double Elo0 = 0.0;
+	double Elo1 = 5.0;
+	double Alpha = 0.05;
+	double Beta = 0.05;
+	int MaxGames = 20000;
+	int Threads = 1;
+	int FirstMap = 0;
+	int TimeTolerance = LocalReferee::DefaultTimeTolerance;
+};
+
+int RunSprt(const SprtConfiguration& aConfiguration);
+
+/**
+* Referee turn replayed in double precision, with the referee cos, sin and rounding instead of the fixed-point ones
+* Far too slow for searches, it only measures how often the Simulator differs from the referee, see --check-simulator
+*/
+class ReferenceSimulator
+{
+public:
+
+	struct ReferencePod
+	{
+		double X;
+		double Y;
+		double VX;
+		double VY;
+		int Angle;
+		int NextCheckpointIndex;
+		int CheckpointsPassed;
+		int ShieldCooldown;
+		bool BoostAvailable;
+		bool Shielded;
+	};
+
+private:
+
+	Simulator _mSimulator;
+
+	void Move(ReferencePod& aPod, double aTime) const;
+
+public:
+
+	static constexpr int CheckGames = 2000;
+	static constexpr int CheckTurns = 400;
+	static constexpr int BenchmarkRollouts = 200000;
+	static constexpr int BenchmarkDepth = 6;
+
+	explicit ReferenceSimulator(const Simulator& aSimulator) :
+		_mSimulator(aSimulator)
+	{
+
+	}
+
+	static ReferencePod FromState(const PodState& aPod);
+	static bool Matches(const ReferencePod& aReference, const PodState& aPod);
+
+	// Play a turn as the referee does, return the number of collisions
+	int PlayTurn(ReferencePod* aPods, const PodMove* aMoves, int aPodCount) const;
+};
+
+// Play long games with both simulators on the map corpus, report the turns they disagree on and the rollouts per second of each
+int RunSimulatorCheck();
+
+/**
+* Depth-first search over 9 moves per turn (rotations -18, 0 and 18 at full thrust for each of our pods, opponents racing
+* straight), played once copying the GameState for every node and once applying and undoing turns on a single state
+* through a log of what each turn overwrites. The undo log only lives here : a turn overwrites almost the whole
+* 128 bytes GameState, so it can not beat the copy, see --state-benchmark
+*/
+class StateSearchBenchmark
+{
+public:
+
+	static constexpr int Depth = 6;
+	static constexpr int Branches = 9;
+	static constexpr int Repetitions = 3;
+
+private:
+
+	/**
+	* Everything a turn overwrites, the GameState without its alignment padding
+	*/
+	struct UndoEntry
+	{
+		PodState Pods[4];
+		int16_t TimeLeft[2];
+		int16_t Turn;
+	};
+
+	const Simulator& _mSimulator;
+	UndoEntry _mUndoLog[Depth];
+	int _mUndoDepth;
+	long long _mNodes;
+
+	void BranchMoves(const GameState& aState, int aBranch, PodMove* aMoves) const;
+	int64_t Evaluate(const GameState& aState) const;
+	void Apply(GameState& aState, const PodMove* aMoves);
+	void Undo(GameState& aState);
+
+public:
+
+	explicit StateSearchBenchmark(const Simulator& aSimulator) :
+		_mSimulator(aSimulator),
+		_mUndoDepth(0),
+		_mNodes(0)
+	{
+
+	}
+
+	long long Nodes() const { return _mNodes; }
+
+	// Best leaf score below aState, copying the state for every child
+	int64_t CopySearch(const GameState& aState, int aDepth);
+	// Best leaf score below aState, playing and reverting every child on aState itself
+	int64_t UndoSearch(GameState& aState, int aDepth);
+};
+
+// Time both StateSearchBenchmark searches from a corpus start
+int RunStateBenchmark();
+
+// Search the same corpus positions with 1 to aMaxThreads threads of ParallelSearchEngine, report candidates and scores per turn
+int RunSearchScaling(int aMaxThreads);
+
+// ===================================
+// ==== Inline implementations
+// ===================================
+
+
+// ==== Checkpoint ====
+float Checkpoint::Radius = 600.0f;
+
+// ==== Pod ====
+int Pod::MaxThrust = 100;
+
+inline bool Pod::IsRacer() const
+{
+	return _mStrategy->IsRacer();
+}
+
+inline void Pod::UpdateFromStandardInput()
+{
+	int x, y, vx, vy, angle, nextCheckpointIndex;
+	std::cin >> x >> y >> vx >> vy >> angle >> nextCheckpointIndex; std::cin.ignore();
+
+	_mPosition = { x,y };
+	_mSpeed = { vx, vy };
+	_mAngle = angle;
+	_mNextCheckpointIndex = nextCheckpointIndex;
+
+	// Laps, boost and shield cooldown are maintained by the WorldEstimator
+	_mShieldUsed = false;
+	_mBoostUsed = false;
+}
+
+inline void Pod::UpdateFromEstimation(const PodState& aState, int aCheckpointCount)
+{
+	_mCheckpointsPassed = aState.CheckpointsPassed;
+	_mCurrentLap = aState.CheckpointsPassed / aCheckpointCount;
+	_mBoostAvailable = aState.BoostAvailable;
+	_mShieldCooldown = aState.ShieldCooldown;
+}
+
+inline PodState Pod::State() const
+{
+	PodState state = {};
+	state.X = static_cast<int16_t>(_mPosition.X);
+	state.Y = static_cast<int16_t>(_mPosition.Y);
+	state.VX = static_cast<int16_t>(_mSpeed.X);
+	state.VY = static_cast<int16_t>(_mSpeed.Y);
+	state.Angle = static_cast<int16_t>(FixedTrigonometry::NormalizeAngle(_mAngle));
+	state.NextCheckpointIndex = static_cast<uint8_t>(_mNextCheckpointIndex);
+	state.CheckpointsPassed = static_cast<uint16_t>(_mCheckpointsPassed);
+	state.ShieldCooldown = static_cast<uint8_t>(_mShieldCooldown);
+	state.BoostAvailable = _mBoostAvailable;
+	return state;
+}
+
+inline void Pod::UpdateStrategy(PodStrategy& aStrategy)
+{
+	_mStrategy = &aStrategy;
+}
+
+inline std::string Pod::Compute(const SimulationEntry& aSimulationEntry)
+{
+	SimulationResult result = _mStrategy->Compute(*this, aSimulationEntry);
+	if (result.Boost)
+	{
+		std::cerr << "BOOST" << std::endl;
+		return std::to_string(result.X) + " " + std::to_string(result.Y) + " " + "BOOST";
+	}
+	if (result.Shield)
+	{
+		std::cerr << "SHIELD" << std::endl;
+		return std::to_string(result.X) + " " + std::to_string(result.Y) + " " + "SHIELD";
+	}
+
+	return std::to_string(result.X) + " " + std::to_string(result.Y) + " " + std::to_string(result.Thrust);
+}
+
+inline std::string Pod::Output(const PodState& aState, const PodMove& aMove)
+{
+	const Vector2<int> target = Simulator::TargetOf(aState, aMove);
+	const std::string position = std::to_string(target.X) + " " + std::to_string(target.Y) + " ";
+	_mTarget = target;
+
+	if (aMove.Thrust == PodMove::Shield)
+	{
+		RequestShield();
+		return position + "SHIELD";
+	}
+	if (aMove.Thrust == PodMove::Boost && _mBoostAvailable)
+	{
+		_mBoostUsed = true;
+		_mBoostAvailable = false;
+		return position + "BOOST";
+	}
+
+	// Boost once it is used is full thrust, as the simulator plays it
+	_mThrust = (aMove.Thrust == PodMove::Boost) ? (MaxThrust) : (std::clamp<int>(aMove.Thrust, 0, MaxThrust));
+	return position + std::to_string(_mThrust);
+}
+
+inline PodMove Pod::LastMove(const PodState& aState) const
+{
+	PodMove move;
+	move.Rotation = static_cast<int16_t>(Simulator::RotationToward(aState, _mTarget));
+
+	// Same priority as the output, boost first
+	if (_mBoostUsed)
+		move.Thrust = PodMove::Boost;
+	else if (_mShieldUsed)
+		move.Thrust = PodMove::Shield;
+	else
+		move.Thrust = static_cast<int16_t>(std::clamp(_mThrust, 0, MaxThrust));
+	return move;
+}
+
+// ==== Simulator ====
+inline Simulator::Simulator(const CheckpointManager& aCheckpointManager) :
+	_mCheckpointCount(std::min(aCheckpointManager.NumberOfCheckpoint(), MaxCheckpoints))
+{
+	for (int i = 0; i < _mCheckpointCount; i++)
+	{
+		_mCheckpoints[i] = aCheckpointManager[i].Position();
+	}
+}
+
+inline PodMove Simulator::StraightMove(const PodState& aPod) const
+{
+	PodMove move;
+	move.Rotation = static_cast<int16_t>(RotationToward(aPod, _mCheckpoints[aPod.NextCheckpointIndex]));
+	move.Thrust = MaxThrust;
+	return move;
+}
+
+inline int Simulator::RotationToward(const PodState& aPod, Vector2<int> aTarget)
+{
+	if (aTarget.X == aPod.X && aTarget.Y == aPod.Y)
+		return 0;
+
+	const double pi = std::acos(-1.0);
+	const int desiredAngle = static_cast<int>(std::lround(std::atan2(aTarget.Y - aPod.Y, aTarget.X - aPod.X) * 180.0 / pi));
+	const int rotation = FixedTrigonometry::NormalizeAngle(desiredAngle - aPod.Angle + 180) - 180;
+	return std::clamp(rotation, -MaxRotation, MaxRotation);
+}
+
+inline Vector2<int> Simulator::TargetOf(const PodState& aPod, const PodMove& aMove)
+{
+	const FixedTrigonometry& trigonometry = FixedTrigonometry::Instance();
+	const int angle = FixedTrigonometry::NormalizeAngle(aPod.Angle + std::clamp<int>(aMove.Rotation, -MaxRotation, MaxRotation));
+
+	// Far enough for the referee to compute the exact same angle once rounded
+	constexpr int distance = 10000;
+	return Vector2<int>(aPod.X + FixedPoint::Round(trigonometry.CosScaled(angle, distance)),
+		aPod.Y + FixedPoint::Round(trigonometry.SinScaled(angle, distance)));
+}
+
+inline bool Simulator::CollisionTime(const MovingPod& aPodA, const MovingPod& aPodB, int64_t aRemainingTime, int64_t& aTime) const
+{
+	constexpr int radiusSum = 2 * PodRadius;
+
+	// Integer broad phase : the gap can not close by more than the relative speed, no need to go further
+	const int64_t dx = (aPodB.X - aPodA.X) / FixedPoint::One;
+	const int64_t dy = (aPodB.Y - aPodA.Y) / FixedPoint::One;
+	const int64_t wx = (aPodB.VX - aPodA.VX) / FixedPoint::One;
+	const int64_t wy = (aPodB.VY - aPodA.VY) / FixedPoint::One;
+	if (std::max(std::abs(dx), std::abs(dy)) > radiusSum + std::abs(wx) + std::abs(wy) + 2)
+		return false;
+
+	// Narrow phase, solving |d + w * t| = radiusSum
+	const double one = static_cast<double>(FixedPoint::One);
+	const double px = (aPodB.X - aPodA.X) / one;
+	const double py = (aPodB.Y - aPodA.Y) / one;
+	const double vx = (aPodB.VX - aPodA.VX) / one;
+	const double vy = (aPodB.VY - aPodA.VY) / one;
+
+	const double a = vx * vx + vy * vy;
+	const double b = px * vx + py * vy;
+	const double c = px * px + py * py - double(radiusSum) * radiusSum;
+
+	// Moving away from each other
+	if (b >= 0.0 || a == 0.0)
+		return false;
+
+	if (c <= 0.0)
+	{
+		aTime = 0;
+		return true;
+	}
+
+	const double discriminant = b * b - a * c;
+	if (discriminant < 0.0)
+		return false;
+
+	const double time = (-b - std::sqrt(discriminant)) / a;
+	if (time * one >= aRemainingTime)
+		return false;
+
+	aTime = static_cast<int64_t>(time * one);
+	return true;
+}
+
+inline void Simulator::Bounce(MovingPod& aPodA, MovingPod& aPodB, bool aShieldedA, bool aShieldedB) const
+{
+	const double one = static_cast<double>(FixedPoint::One);
+	const double massA = aShieldedA ? ShieldMass : 1.0;
+	const double massB = aShieldedB ? ShieldMass : 1.0;
+	const double massCoefficient = (massA + massB) / (massA * massB);
+
+	const double nx = (aPodA.X - aPodB.X) / one;
+	const double ny = (aPodA.Y - aPodB.Y) / one;
+	const double distanceSqr = nx * nx + ny * ny;
+	const double dvx = (aPodA.VX - aPodB.VX) / one;
+	const double dvy = (aPodA.VY - aPodB.VY) / one;
+	const double product = nx * dvx + ny * dvy;
+
+	double fx = (nx * product) / (distanceSqr * massCoefficient);
+	double fy = (ny * product) / (distanceSqr * massCoefficient);
+
+	double vxA = aPodA.VX / one - fx / massA;
+	double vyA = aPodA.VY / one - fy / massA;
+	double vxB = aPodB.VX / one + fx / massB;
+	double vyB = aPodB.VY / one + fy / massB;
+
+	// The referee apply the impulse a second time, with a minimum magnitude
+	const double impulse = std::sqrt(fx * fx + fy * fy);
+	if (impulse > 0.0 && impulse < MinImpulse)
+	{
+		fx = fx * MinImpulse / impulse;
+		fy = fy * MinImpulse / impulse;
+	}
+
+	vxA -= fx / massA;
+	vyA -= fy / massA;
+	vxB += fx / massB;
+	vyB += fy / massB;
+
+	aPodA.VX = std::llround(vxA * one);
+	aPodA.VY = std::llround(vyA * one);
+	aPodB.VX = std::llround(vxB * one);
+	aPodB.VY = std::llround(vyB * one);
+}
+
+inline void Simulator::Move(PodState& aPod, MovingPod& aMovingPod, int64_t aTime) const
+{
+	const int64_t dx = aMovingPod.VX * aTime / FixedPoint::One;
+	const int64_t dy = aMovingPod.VY * aTime / FixedPoint::One;
+
+	// Checkpoint is crossed when the segment travelled during aTime comes closer than the radius from its center
+	// Done on whole units, which is more than enough precision for a 600 radius
+	const Vector2<int>& checkpoint = _mCheckpoints[aPod.NextCheckpointIndex];
+	const int64_t ex = checkpoint.X - FixedPoint::Round(aMovingPod.X);
+	const int64_t ey = checkpoint.Y - FixedPoint::Round(aMovingPod.Y);
+	const int64_t sx = FixedPoint::Round(dx);
+	const int64_t sy = FixedPoint::Round(dy);
+	const int64_t radiusSqr = int64_t(CheckpointRadius) * CheckpointRadius;
+
+	const int64_t dotStart = ex * sx + ey * sy;
+	const int64_t segmentSqr = sx * sx + sy * sy;
+	bool crossed = false;
+	if (dotStart <= 0 || segmentSqr == 0)
+	{
+		crossed = ex * ex + ey * ey < radiusSqr;
+	}
+	else if (dotStart >= segmentSqr)
+	{
+		crossed = (ex - sx) * (ex - sx) + (ey - sy) * (ey - sy) < radiusSqr;
+	}
+	else
+	{
+		crossed = (ex * ex + ey * ey) * segmentSqr - dotStart * dotStart < radiusSqr * segmentSqr;
+	}
+
+	if (crossed)
+	{
+		aPod.NextCheckpointIndex = (aPod.NextCheckpointIndex + 1) % _mCheckpointCount;
+		aPod.CheckpointsPassed++;
+	}
+
+	aMovingPod.X += dx;
+	aMovingPod.Y += dy;
+}
+
+inline void Simulator::PlayTurn(PodState* aPods, const PodMove* aMoves, int aPodCount) const
+{
+	const FixedTrigonometry& trigonometry = FixedTrigonometry::Instance();
+	MovingPod movingPods[MaxPods];
+
+	// -- Rotation, then thrust along the new angle
+	for (int i = 0; i < aPodCount; i++)
+	{
+		PodState& pod = aPods[i];
+		const PodMove& move = aMoves[i];
+		pod.Angle = FixedTrigonometry::NormalizeAngle(pod.Angle + std::clamp<int>(move.Rotation, -MaxRotation, MaxRotation));
+		pod.Shielded = 0;
+
+		int thrust = move.Thrust;
+		if (thrust == PodMove::Shield)
+		{
+			pod.Shielded = 1;
+			pod.ShieldCooldown = ShieldCooldown;
+			thrust = 0;
+		}
+		else if (pod.ShieldCooldown > 0)
+		{
+			pod.ShieldCooldown--;
+			thrust = 0;
+		}
+		else if (thrust == PodMove::Boost)
+		{
+			thrust = pod.BoostAvailable ? BoostThrust : MaxThrust;
+			pod.BoostAvailable = 0;
+		}
+
+		movingPods[i].X = FixedPoint::FromInt(pod.X);
+		movingPods[i].Y = FixedPoint::FromInt(pod.Y);
+		movingPods[i].VX = FixedPoint::FromInt(pod.VX) + trigonometry.CosScaled(pod.Angle, thrust);
+		movingPods[i].VY = FixedPoint::FromInt(pod.VY) + trigonometry.SinScaled(pod.Angle, thrust);
+	}
+
+	// -- Movement, stopping at each collision to resolve it
+	int64_t remainingTime = FixedPoint::One;
+	int lastPodA = -1;
+	int lastPodB = -1;
+	while (true)
+	{
+		int64_t firstTime = remainingTime;
+		int firstPodA = -1;
+		int firstPodB = -1;
+		for (int i = 0; i < aPodCount; i++)
+		{
+			for (int j = i + 1; j < aPodCount; j++)
+			{
+				// Pods that just bounced are still touching, don't make them collide again
+				if (i == lastPodA && j == lastPodB)
+					continue;
+
+				int64_t time;
+				if (CollisionTime(movingPods[i], movingPods[j], remainingTime, time) && time < firstTime)
+				{
+					firstTime = time;
+					firstPodA = i;
+					firstPodB = j;
+				}
+			}
+		}
+
+		for (int i = 0; i < aPodCount; i++)
+		{
+			Move(aPods[i], movingPods[i], firstTime);
+		}
+		remainingTime -= firstTime;
+
+		if (firstPodA < 0)
+			break;
+
+		Bounce(movingPods[firstPodA], movingPods[firstPodB], aPods[firstPodA].Shielded, aPods[firstPodB].Shielded);
+		lastPodA = firstPodA;
+		lastPodB = firstPodB;
+	}
+
+	// -- End of turn, the referee round positions and truncate speeds after friction
+	for (int i = 0; i < aPodCount; i++)
+	{
+		PodState& pod = aPods[i];
+		pod.X = static_cast<int16_t>(FixedPoint::Round(movingPods[i].X));
+		pod.Y = static_cast<int16_t>(FixedPoint::Round(movingPods[i].Y));
+		pod.VX = static_cast<int16_t>(FixedPoint::Truncate(movingPods[i].VX * FrictionPercent / 100));
+		pod.VY = static_cast<int16_t>(FixedPoint::Truncate(movingPods[i].VY * FrictionPercent / 100));
+	}
+}
+
+inline void Simulator::PlayTurn(GameState& aState, const PodMove* aMoves) const
+{
+	uint16_t checkpointsPassed[4];
+	for (int i = 0; i < 4; i++)
+	{
+		checkpointsPassed[i] = aState.Pods[i].CheckpointsPassed;
+	}
+
+	PlayTurn(aState.Pods, aMoves, 4);
+
+	// A player timeout is reset as soon as one of its pods pass a checkpoint
+	for (int player = 0; player < 2; player++)
+	{
+		const bool passed = aState.Pods[2 * player].CheckpointsPassed != checkpointsPassed[2 * player]
+			|| aState.Pods[2 * player + 1].CheckpointsPassed != checkpointsPassed[2 * player + 1];
+		aState.TimeLeft[player] = passed ? Timeout : aState.TimeLeft[player] - 1;
+	}
+	aState.Turn++;
+}
+
+// ==== Pod Strategy ====
+inline bool PodStrategy::Collision(const Pod& podA, const Pod& podB)
+{
+	const Vector2<int> podANextPosition = podA.Position() + podA.Speed();
+	const Vector2<int> podBNextPosition = podB.Position() + podB.Speed();
+	bool collision = (podANextPosition.DistanceSqr(podBNextPosition) < ((2 * 420) * (2 * 420)));
+
+	return collision;
+}
+
+inline void PodStrategy::ComputeThrust(Pod& pod, const SimulationEntry& aSimulationEntry)
+{
+	Checkpoint podTargetCheckpoint = aSimulationEntry.checkpointManager[pod.NextCheckpointIndex()];
+
+	if (ShouldUseShield(pod, aSimulationEntry))
+	{
+		pod.RequestShield();
+	}
+
+	float actualAngle = ComputeAngle(pod, pod.Target());
+	float angleDifference = abs((int)(actualAngle - pod.Angle()));
+
+	if (angleDifference < 2 && pod.Target().Distance(pod.Position()) > 650)
+	{
+		pod.SetThrust(pod.MaxThrust);
+
+		if (podTargetCheckpoint.IsBestBoostIndex())
+			pod.RequestBoost();
+	}
+	else
+	{
+		const Vector2<int> targetPosition = pod.Target();
+		// Try to minimize drifting
+		pod.SetTarget(targetPosition - (pod.Speed() * 3.f));
+
+		float distanceToTarget = targetPosition.Distance(pod.Position());
+		float distanceSlowdownFactor = std::clamp(distanceToTarget / (2.f * Checkpoint::Radius), 0.f, 1.f);
+
+		float angleToTarget = ComputeAngle(pod, pod.Target());
+		float angle = angleToTarget - pod.Angle();
+		float angleSlowdownFactor = 1.f - std::clamp(abs((int)angle) / 90.f, 0.f, 1.f);
+
+		pod.SetThrust(pod.MaxThrust * distanceSlowdownFactor * angleSlowdownFactor);
+	}
+}
+
+// ==== Standard Pod Strategy ====
+
+inline bool RacerPodStrategy::BeneficialCollision(const Pod& podA, const Pod& podB)
+{
+	// Dot product of two normalized vectors gives a value between -1 and 1
+	// 0 = Vectors are perpendicular
+	// 1 = Vectors are parallel (facing the same direction)
+	// -1 = Vectors are anti-parallel (facing the opposite direction)
+	// 
+	// 0.5 seems a reasonable value, meaning the pod will still be more or less pushed into the good direction
+	const Vector2<float> podADirection = (podA.Target() - podA.Position()).Normalize();
+	const Vector2<float> podBDirectionSmashingA = (podA.Position() - podB.Position()).Normalize();
+	std::cerr << podA.Position().X << " - " << podB.Position().X << std::endl;
+	std::cerr << "Direction X " << (podA.Position() - podB.Position()).X << std::endl;
+	float dot = podADirection.Dot(podBDirectionSmashingA);
+	return dot > 0.5f;
+}
+
+inline bool RacerPodStrategy::ShouldUseShield(Pod& pod, const SimulationEntry& aSimulationEntry)
+{
+	Pod& otherPod = (aSimulationEntry.myPods[0].IsRacer()) ? (aSimulationEntry.myPods[1]) : (aSimulationEntry.myPods[0]);
+	Pod& opponentPod1 = aSimulationEntry.opponentPods[0];
+	Pod& opponentPod2 = aSimulationEntry.opponentPods[1];
+
+	if (Collision(pod, otherPod))
+	{
+		if (BeneficialCollision(pod, otherPod))
+			return false;
+
+		//return true;
+		return true;
+	}
+
+	if (Collision(pod, opponentPod1))
+	{
+		if (BeneficialCollision(pod, opponentPod1))
+			return false;
+
+		return true;
+	}
+
+	if (Collision(pod, opponentPod2))
+	{
+		if (BeneficialCollision(pod, opponentPod2))
+			return false;
+
+		return true;
+	}
+
+	return false;
+}
+
+inline Vector2<int> RacerPodStrategy::ComputeTarget(Pod& pod, const SimulationEntry& aSimulationEntry)
 {
 	Checkpoint nextNextCheckpoint = aSimulationEntry.checkpointManager[(pod.NextCheckpointIndex() + 1) % aSimulationEntry.checkpointManager.NumberOfCheckpoint()];
 
-	Vector2<int> nextPosition = pod.Position() + pod.Speed();
-	std::cerr << nextPosition.Distance(pod.Target()) << std::endl;
-	if (nextPosition.Distance(pod.Target()) < 1400)
+	Vector2<int> nextPosition = pod.Position() + pod.Speed();
+	std::cerr << nextPosition.Distance(pod.Target()) << std::endl;
+	if (nextPosition.Distance(pod.Target()) < 1400)
+	{
+		return nextNextCheckpoint.Position();
+	}
+	else
+		return aSimulationEntry.checkpointManager[pod.NextCheckpointIndex()].Position();
+}
+
+inline SimulationResult RacerPodStrategy::Compute(Pod& pod, const SimulationEntry& aSimulationEntry)
+{
+	pod.SetTarget(ComputeTarget(pod, aSimulationEntry));
+	ComputeThrust(pod, aSimulationEntry);
+	return SimulationResult(pod.BoostUsed(), pod.ShieldUsed(), pod.Target().X, pod.Target().Y, pod.Thrust());
+
+}
+
+// == Interceptor Pod Strategy
+
+inline Vector2<int> InterceptorPodStrategy::ComputeTarget(Pod& pod, const SimulationEntry& aSimulationEntry)
+{
+	Vector2<int> target = { 0, 0 };
+
+	Pod& opponent = aSimulationEntry.opponentPods[aSimulationEntry.indexRacerOpponent];
+	Vector2<int> opponentTarget = aSimulationEntry.checkpointManager[opponent.NextCheckpointIndex()].Position();
+	Vector2<int> opponentDirection = (opponentTarget - pod.Position());
+	Vector2<int> direction = (opponent.Position() - pod.Position());
+
+	bool canReachOpponentRacer = [&]() -> bool
+	{
+		// If dot product return a value higher than 0, it's mean they face the same direction
+		// And pushing the opponentRacer would not be efficient
+		if (direction.Dot(opponentDirection) > 0)
+			return false;
+
+		// If opponent pod is closer to his target than our interceptor, we can't reach it before him
+		if (pod.Position().DistanceSqr(opponentTarget) > opponent.Position().DistanceSqr(opponentTarget))
+			return false;
+
+		return true;
+	}();
+
+	if (canReachOpponentRacer)
+	{
+		return opponent.Position() + opponent.Speed()* 3.f;
+	}
+	// Because our interceptor is not able to reach the opponent pod at this stage, we'll check where we can wait it
+	// To do it, we'll check checkpoint by checkpoint, adding distance separating each other in a quite rough computation
+	// And stop when we see that our pod can reach it before opponent pod
+	float opponentDistance = 0;
+	Vector2<int> opponentCheckpointPositionToReach = opponent.Position();
+	for (int i = 0; i < aSimulationEntry.checkpointManager.NumberOfCheckpoint(); i++)
+	{
+		int nextCheckpointIndex = (opponent.NextCheckpointIndex() + 1) % (aSimulationEntry.checkpointManager.NumberOfCheckpoint());
+		Vector2<int> nextCheckpointPosition = aSimulationEntry.checkpointManager[nextCheckpointIndex].Position();
+
+		opponentDistance += opponentCheckpointPositionToReach.Distance(nextCheckpointPosition);
+		float podDistance = pod.Position().Distance(nextCheckpointPosition);
+
+		opponentCheckpointPositionToReach = nextCheckpointPosition;
+		if (podDistance < opponentDistance)
+			break;
+	}
+
+	return opponentCheckpointPositionToReach;
+}
+
+inline bool InterceptorPodStrategy::BeneficialCollision(const Pod& podA, const Pod& podB)
+{
+	// Dot product of two normalized vectors gives a value between -1 and 1
+	// 0 = Vectors are perpendicular
+	// 1 = Vectors are parallel (facing the same direction)
+	// -1 = Vectors are anti-parallel (facing the opposite direction)
+	// 
+	// 0.5 seems a reasonable value, meaning the pod will push his target into a quite undesirable position
+	const Vector2<float> podADirection = (podA.Target() - podA.Position()).Normalize();
+	const Vector2<float> podBDirection = (podB.Target() - podB.Position()).Normalize();
+	return podADirection.Dot(podBDirection) < 0.5f;
+}
+
+inline bool InterceptorPodStrategy::ShouldUseShield(Pod& pod, const SimulationEntry& aSimulationEntry)
+{
+	Pod& otherPod = (aSimulationEntry.myPods[0].IsRacer()) ? (aSimulationEntry.myPods[0]) : (aSimulationEntry.myPods[1]);
+	Pod& opponentPod1 = aSimulationEntry.opponentPods[0];
+	Pod& opponentPod2 = aSimulationEntry.opponentPods[1];
+
+	if (Collision(pod, otherPod))
+	{
+		if (BeneficialCollision(pod, otherPod))
+			return false;
+
+		return true;
+	}
+
+	if (Collision(pod, opponentPod1))
+	{
+		if (BeneficialCollision(pod, opponentPod1))
+			return true;
+
+		return false;
+	}
+
+	if (Collision(pod, opponentPod2))
+	{
+		if (BeneficialCollision(pod, opponentPod2))
+			return true;
+
+		return false;
+	}
+
+	return false;
+}
+
+inline SimulationResult InterceptorPodStrategy::Compute(Pod& pod, const SimulationEntry& aSimulationEntry)
+{
+	pod.SetTarget(ComputeTarget(pod, aSimulationEntry));
+	ComputeThrust(pod, aSimulationEntry);
+	return SimulationResult(pod.BoostUsed(), pod.ShieldUsed(), pod.Target().X, pod.Target().Y, pod.Thrust());
+}
+
+// == Racer Lookup Table
+
+inline RacerLookupTable::Action RacerLookupTable::Solve(const Simulator& aSimulator, int aForwardSpeed, int aLateralSpeed, int aAngle, int aDistance) const
+{
+	// The synthetic race is seen along the X axis, checkpoint 0 being the next one and 1 the following one
+	PodState start = {};
+	start.X = static_cast<int16_t>(aSimulator.CheckpointPosition(0).X - std::lround(DistanceCenter(aDistance)));
+	start.Y = static_cast<int16_t>(aSimulator.CheckpointPosition(0).Y);
+	start.VX = static_cast<int16_t>(std::lround(ForwardSpeedCenter(aForwardSpeed)));
+	start.VY = static_cast<int16_t>(std::lround(LateralSpeedCenter(aLateralSpeed)));
+	start.Angle = static_cast<int16_t>(FixedTrigonometry::NormalizeAngle(static_cast<int>(std::lround(AngleCenter(aAngle)))));
+
+	static const int rotations[5] = { -18, -9, 0, 9, 18 };
+	static const int thrusts[3] = { 0, 50, 100 };
+	const double pi = std::acos(-1.0);
+
+	Action best = { 0, 100 };
+	float bestScore = -std::numeric_limits<float>::max();
+	for (int rotation : rotations)
+	{
+		for (int thrust : thrusts)
+		{
+			PodState pod = start;
+			PodMove move = { static_cast<int16_t>(rotation), static_cast<int16_t>(thrust) };
+			aSimulator.PlayTurn(&pod, &move, 1);
+
+			// Then a plain rollout toward the checkpoint to reach, compensating the drift and slowing down while facing away.
+			// Late crossings are penalized, otherwise waiting always looks as good as crossing now and then drifting from the next one
+			float lateness = 0.f;
+			for (int turn = 1; turn < SimulatedTurns; turn++)
+			{
+				const Vector2<int> target = aSimulator.CheckpointPosition(pod.NextCheckpointIndex) - Vector2<int>(pod.VX * 3, pod.VY * 3);
+				const double desiredAngle = std::atan2(target.Y - pod.Y, target.X - pod.X) * 180.0 / pi;
+				const double angleDifference = std::fabs(std::remainder(desiredAngle - pod.Angle, 360.0));
+				move.Rotation = static_cast<int16_t>(Simulator::RotationToward(pod, target));
+				move.Thrust = static_cast<int16_t>(std::lround(Simulator::MaxThrust * (1.0 - std::min(angleDifference / 90.0, 1.0))));
+
+				const int passed = pod.CheckpointsPassed;
+				aSimulator.PlayTurn(&pod, &move, 1);
+				lateness += (pod.CheckpointsPassed - passed) * turn * LatenessPenalty;
+			}
+
+			const Vector2<int> position(pod.X, pod.Y);
+			const float score = pod.CheckpointsPassed * 20000.f - lateness - position.Distance(aSimulator.CheckpointPosition(pod.NextCheckpointIndex));
+			if (score > bestScore)
+			{
+				bestScore = score;
+				best = { static_cast<int8_t>(rotation), static_cast<uint8_t>(thrust) };
+			}
+		}
+	}
+
+	return best;
+}
+
+inline void RacerLookupTable::Build()
+{
+	const auto start = std::chrono::steady_clock::now();
+	_mActions.assign(CellCount, Action{ 0, 100 });
+
+	for (int legAngle = 0; legAngle < LegAngleBins; legAngle++)
+	{
+		const double pi = std::acos(-1.0);
+		const Vector2<int> next(9000, 4500);
+		const Vector2<int> following(next.X + static_cast<int>(std::lround(LegLength * std::cos(LegAngleCenter(legAngle) * pi / 180.0))),
+			next.Y + static_cast<int>(std::lround(LegLength * std::sin(LegAngleCenter(legAngle) * pi / 180.0))));
+
+		CheckpointManager checkpoints;
+		checkpoints.Build({ next, following });
+		const Simulator simulator(checkpoints);
+
+		for (int forwardSpeed = 0; forwardSpeed < ForwardSpeedBins; forwardSpeed++)
+			for (int lateralSpeed = 0; lateralSpeed < LateralSpeedBins; lateralSpeed++)
+				for (int angle = 0; angle < AngleBins; angle++)
+					for (int distance = 0; distance < DistanceBins; distance++)
+						_mActions[Index(forwardSpeed, lateralSpeed, angle, legAngle, distance)] = Solve(simulator, forwardSpeed, lateralSpeed, angle, distance);
+	}
+
+	const float elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	std::cerr << "Racer lookup table : " << CellCount << " cells, " << SizeInBytes() << " bytes, built in " << elapsed << "ms" << std::endl;
+}
+
+inline void RacerLookupTable::Lookup(const PodState& aPod, Vector2<int> aNextCheckpoint, Vector2<int> aFollowingCheckpoint, int& aRotation, int& aThrust) const
+{
+	const double pi = std::acos(-1.0);
+	const Vector2<int> position(aPod.X, aPod.Y);
+	const Vector2<float> way = (aNextCheckpoint - position).Normalize();
+	const float wayAngle = static_cast<float>(std::atan2(way.Y, way.X) * 180.0 / pi);
+	const Vector2<int> leg = aFollowingCheckpoint - aNextCheckpoint;
+	const float legAngle = static_cast<float>(std::atan2(leg.Y, leg.X) * 180.0 / pi);
+	const auto relative = [](float aAngle) { return std::fmod(std::fmod(aAngle + 180.f, 360.f) + 360.f, 360.f) - 180.f; };
+
+	float forwardSpeed = aPod.VX * way.X + aPod.VY * way.Y;
+	float lateralSpeed = aPod.VY * way.X - aPod.VX * way.Y;
+	float podAngle = relative(aPod.Angle - wayAngle);
+	float relativeLegAngle = relative(legAngle - wayAngle);
+
+	const bool mirrored = lateralSpeed < 0.f;
+	if (mirrored)
+	{
+		lateralSpeed = -lateralSpeed;
+		podAngle = -podAngle;
+		relativeLegAngle = -relativeLegAngle;
+	}
+
+	const int forwardBin = std::clamp(static_cast<int>(std::floor((forwardSpeed + 200.f) / 200.f)), 0, ForwardSpeedBins - 1);
+	const int lateralBin = std::clamp(static_cast<int>(lateralSpeed / 200.f), 0, LateralSpeedBins - 1);
+	const int legBin = std::clamp(static_cast<int>((relativeLegAngle + 180.f) / 45.f), 0, LegAngleBins - 1);
+
+	// Pod angle is cyclic, the two closest centers may wrap around
+	const float angleCoordinate = (podAngle - AngleCenter(0)) / 30.f;
+	const int angleLow = static_cast<int>(std::floor(angleCoordinate));
+	const float angleWeight = angleCoordinate - angleLow;
+	const int angleBins[2] = { (angleLow + AngleBins) % AngleBins, (angleLow + 1 + AngleBins) % AngleBins };
+
+	const float distance = position.Distance(aNextCheckpoint);
+	int distanceLow = 0;
+	while (distanceLow < DistanceBins - 2 && distance > DistanceCenter(distanceLow + 1))
+	{
+		distanceLow++;
+	}
+	const float distanceWeight = std::clamp((distance - DistanceCenter(distanceLow)) / (DistanceCenter(distanceLow + 1) - DistanceCenter(distanceLow)), 0.f, 1.f);
+
+	float rotation = 0.f;
+	float thrust = 0.f;
+	for (int a = 0; a < 2; a++)
+	{
+		for (int d = 0; d < 2; d++)
+		{
+			const float weight = (a ? angleWeight : 1.f - angleWeight) * (d ? distanceWeight : 1.f - distanceWeight);
+			const Action& action = _mActions[Index(forwardBin, lateralBin, angleBins[a], legBin, distanceLow + d)];
+			rotation += weight * action.Rotation;
+			thrust += weight * action.Thrust;
+		}
+	}
+
+	aRotation = static_cast<int>(std::lround(mirrored ? -rotation : rotation));
+	aThrust = static_cast<int>(std::lround(thrust));
+}
+
+// == Lookup Racer Pod Strategy
+
+inline SimulationResult LookupRacerPodStrategy::Compute(Pod& pod, const SimulationEntry& aSimulationEntry)
+{
+	const CheckpointManager& checkpoints = aSimulationEntry.checkpointManager;
+	const Checkpoint& nextCheckpoint = checkpoints[pod.NextCheckpointIndex()];
+	const Vector2<int> followingCheckpoint = checkpoints[(pod.NextCheckpointIndex() + 1) % checkpoints.NumberOfCheckpoint()].Position();
+
+	const PodState state = pod.State();
+	int rotation, thrust;
+	_mTable->Lookup(state, nextCheckpoint.Position(), followingCheckpoint, rotation, thrust);
+
+	const PodMove move = { static_cast<int16_t>(rotation), static_cast<int16_t>(thrust) };
+	pod.SetTarget(Simulator::TargetOf(state, move));
+	pod.SetThrust(thrust);
+
+	if (ShouldUseShield(pod, aSimulationEntry))
+	{
+		pod.RequestShield();
+	}
+	else if (nextCheckpoint.IsBestBoostIndex() && rotation == 0 && thrust == Simulator::MaxThrust && pod.Position().Distance(nextCheckpoint.Position()) > 4000.f)
+	{
+		pod.RequestBoost();
+	}
+
+	return SimulationResult(pod.BoostUsed(), pod.ShieldUsed(), pod.Target().X, pod.Target().Y, pod.Thrust());
+}
+
+// == Beam Search Racer
+
+inline BeamSearchRacer::BeamSearchRacer(int aWidth) :
+	_mWidth(std::max(1, aWidth)),
+	_mStamp(0),
+	_mNodes(0),
+	_mDepthReached(0),
+	_mElapsed(0.f)
+{
+	// Up to 12 children per node, the table is kept under a quarter full
+	size_t buckets = 1;
+	while (buckets < static_cast<size_t>(_mWidth) * 12 * 4)
+	{
+		buckets *= 2;
+	}
+	_mBucketKeys.resize(buckets);
+	_mBucketStamps.assign(buckets, 0);
+	_mBucketNodes.resize(buckets);
+	_mBeam.reserve(_mWidth);
+	_mChildren.reserve(_mWidth * 12);
+}
+
+inline uint64_t BeamSearchRacer::BucketKey(const PodState& aPod)
+{
+	const int sector = static_cast<int>(std::lround((std::atan2(aPod.VY, aPod.VX) + std::acos(-1.0)) * SpeedSectors / (2.0 * std::acos(-1.0)))) % SpeedSectors;
+	const uint64_t x = static_cast<uint64_t>((aPod.X + 32768) / BucketSize);
+	const uint64_t y = static_cast<uint64_t>((aPod.Y + 32768) / BucketSize);
+	return (((x << 16 | y) << 16 | aPod.CheckpointsPassed) << 8) | static_cast<uint64_t>(sector);
+}
+
+inline void BeamSearchRacer::Evaluate(const Simulator& aSimulator, Node& aNode) const
+{
+	const PodState& pod = aNode.Pod;
+	const Vector2<int> position(pod.X, pod.Y);
+	const Vector2<int> checkpoint = aSimulator.CheckpointPosition(pod.NextCheckpointIndex);
+	const float distance = position.Distance(checkpoint);
+
+	aNode.Progress = pod.CheckpointsPassed * 50000.f - distance;
+	aNode.Speed = (distance > 0.f) ? ((pod.VX * (checkpoint.X - pod.X) + pod.VY * (checkpoint.Y - pod.Y)) / distance) : (0.f);
+}
+
+inline void BeamSearchRacer::Insert(const Node& aNode)
+{
+	const uint64_t key = BucketKey(aNode.Pod);
+	const size_t mask = _mBucketKeys.size() - 1;
+
+	for (size_t slot = (key * 0x9E3779B97F4A7C15ull) >> 40 & mask; ; slot = (slot + 1) & mask)
+	{
+		if (_mBucketStamps[slot] != _mStamp)
+		{
+			_mBucketStamps[slot] = _mStamp;
+			_mBucketKeys[slot] = key;
+			_mBucketNodes[slot] = static_cast<int>(_mChildren.size());
+			_mChildren.push_back(aNode);
+			return;
+		}
+		if (_mBucketKeys[slot] != key)
+			continue;
+
+		Node& other = _mChildren[_mBucketNodes[slot]];
+		if (aNode.Progress <= other.Progress && aNode.Speed <= other.Speed)
+			return;
+		if (aNode.Progress >= other.Progress && aNode.Speed >= other.Speed)
+		{
+			other = aNode;
+			return;
+		}
+
+		// Neither dominates, both are kept, the bucket only remembers the first one
+		_mChildren.push_back(aNode);
+		return;
+	}
+}
+
+inline PodMove BeamSearchRacer::Search(const Simulator& aSimulator, const PodState& aRoot, const TurnDeadline& aDeadline)
+{
+	static const int rotations[3] = { -Simulator::MaxRotation, 0, Simulator::MaxRotation };
+	static const int thrusts[4] = { 0, 50, Simulator::MaxThrust, PodMove::Boost };
+
+	const auto start = std::chrono::steady_clock::now();
+	_mNodes = 0;
+	_mDepthReached = 0;
+	_mBeam.clear();
+	_mBeam.push_back(Node{ aRoot, PodMove{ 0, Simulator::MaxThrust }, 0.f, 0.f });
+
+	bool expired = false;
+	for (int depth = 0; depth < Depth && expired == false; depth++)
+	{
+		_mChildren.clear();
+		_mStamp++;
+
+		for (size_t i = 0; i < _mBeam.size(); i++)
+		{
+			if (depth > 0 && i % DeadlineCheckInterval == 0 && aDeadline.Expired())
+			{
+				expired = true;
+				break;
+			}
+
+			const Node& node = _mBeam[i];
+			for (int thrust : thrusts)
+			{
+				if (thrust == PodMove::Boost && node.Pod.BoostAvailable == 0)
+					continue;
+
+				for (int rotation : rotations)
+				{
+					Node child = node;
+					const PodMove move = { static_cast<int16_t>(rotation), static_cast<int16_t>(thrust) };
+					aSimulator.PlayTurn(&child.Pod, &move, 1);
+					if (depth == 0)
+					{
+						child.FirstMove = move;
+					}
+					Evaluate(aSimulator, child);
+					Insert(child);
+					_mNodes++;
+				}
+			}
+		}
+		if (expired)
+			break;
+
+		const auto better = [](const Node& aFirst, const Node& aSecond) { return aFirst.Progress > aSecond.Progress; };
+		if (static_cast<int>(_mChildren.size()) > _mWidth)
+		{
+			std::nth_element(_mChildren.begin(), _mChildren.begin() + _mWidth, _mChildren.end(), better);
+			_mChildren.resize(_mWidth);
+		}
+		_mBeam.swap(_mChildren);
+		_mDepthReached = depth + 1;
+	}
+
+	_mElapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	const auto best = std::max_element(_mBeam.begin(), _mBeam.end(),
+		[](const Node& aFirst, const Node& aSecond) { return aFirst.Progress < aSecond.Progress; });
+	return best->FirstMove;
+}
+
+// == Beam Racer Pod Strategy
+
+inline SimulationResult BeamRacerPodStrategy::Compute(Pod& pod, const SimulationEntry& aSimulationEntry)
+{
+	const Simulator simulator(aSimulationEntry.checkpointManager);
+	const PodState state = pod.State();
+	const auto now = std::chrono::steady_clock::now();
+	const TurnDeadline unlimited(now, std::chrono::steady_clock::time_point::max());
+	const PodMove move = _mSearch->Search(simulator, state, (_mDeadline != nullptr) ? (*_mDeadline) : (unlimited));
+
+	std::cerr << "Beam : width " << _mSearch->Width() << ", depth " << _mSearch->DepthReached() << "/" << BeamSearchRacer::Depth
+		<< ", " << _mSearch->Nodes() << " nodes in " << _mSearch->Elapsed() << "ms ("
+		<< std::lround(_mSearch->Nodes() / std::max(1e-3f, _mSearch->Elapsed())) << " nodes/ms)" << std::endl;
+
+	pod.SetTarget(Simulator::TargetOf(state, move));
+	pod.SetThrust((move.Thrust == PodMove::Boost) ? (Simulator::MaxThrust) : (move.Thrust));
+
+	if (ShouldUseShield(pod, aSimulationEntry))
+	{
+		pod.RequestShield();
+	}
+	else if (move.Thrust == PodMove::Boost)
+	{
+		pod.RequestBoost();
+	}
+
+	return SimulationResult(pod.BoostUsed(), pod.ShieldUsed(), pod.Target().X, pod.Target().Y, pod.Thrust());
+}
+
+// ==== Monte Carlo Search Engine ====
+
+inline void MonteCarloSearchEngine::BuildGreedySolution(const TurnContext& aContext, Solution& aSolution) const
+{
+	const Simulator& simulator = *aContext.TurnSimulator;
+	GameState state = aContext.State;
+
+	for (int depth = 0; depth < Depth; depth++)
+	{
+		PodMove moves[4];
+		for (int i = 0; i < 4; i++)
+		{
+			moves[i] = simulator.StraightMove(state.Pods[i]);
+		}
+
+		aSolution.Moves[depth][0] = moves[0];
+		aSolution.Moves[depth][1] = moves[1];
+		simulator.PlayTurn(state, moves);
+	}
+}
+
+inline int MonteCarloSearchEngine::Mutate(Solution& aSolution, float aAmplitude)
+{
+	const int depth = _mRandom.Range(0, Depth - 1);
+	const int pod = _mRandom.Range(0, 1);
+	PodMove& move = aSolution.Moves[depth][pod];
+
+	const int roll = _mRandom.Range(0, 99);
+	if (roll < 2)
+	{
+		move.Thrust = PodMove::Shield;
+	}
+	else if (roll < 4 && _mStates[depth].Pods[pod].BoostAvailable)
+	{
+		move.Thrust = PodMove::Boost;
+	}
+	else if (roll < 52)
+	{
+		const int amplitude = std::max(1, static_cast<int>(aAmplitude * Simulator::MaxRotation));
+		move.Rotation = std::clamp(move.Rotation + _mRandom.Range(-amplitude, amplitude), -Simulator::MaxRotation, Simulator::MaxRotation);
+	}
+	else
+	{
+		const int amplitude = std::max(1, static_cast<int>(aAmplitude * Simulator::MaxThrust));
+		const int thrust = (move.Thrust < 0) ? (Simulator::MaxThrust) : (move.Thrust);
+		move.Thrust = std::clamp(thrust + _mRandom.Range(-amplitude, amplitude), 0, Simulator::MaxThrust);
+	}
+
+	return depth;
+}
+
+inline float MonteCarloSearchEngine::EvaluateState(const TurnContext& aContext, const GameState& aState) const
+{
+	const Simulator& simulator = *aContext.TurnSimulator;
+	const int checkpointsToWin = aContext.Laps * simulator.NumberOfCheckpoint();
+
+	if (aState.TimeLeft[0] <= 0)
+		return -1e9f;
+	if (aState.TimeLeft[1] <= 0)
+		return 1e9f;
+
+	float progress[4];
+	for (int i = 0; i < 4; i++)
+	{
+		const PodState& pod = aState.Pods[i];
+		if (pod.CheckpointsPassed >= checkpointsToWin)
+			return (i < 2) ? (1e9f) : (-1e9f);
+
+		const Vector2<int> position(pod.X, pod.Y);
+		progress[i] = pod.CheckpointsPassed * 50000.f - position.Distance(simulator.CheckpointPosition(pod.NextCheckpointIndex));
+	}
+
+	const int myRacer = (progress[0] >= progress[1]) ? (0) : (1);
+	const int myInterceptor = 1 - myRacer;
+	const int opponentRacer = (progress[2] >= progress[3]) ? (2) : (3);
+
+	// Our interceptor wait the opponent racer on its way to the next checkpoint
+	const Vector2<int> interceptor(aState.Pods[myInterceptor].X, aState.Pods[myInterceptor].Y);
+	const Vector2<int> opponentTarget = simulator.CheckpointPosition(aState.Pods[opponentRacer].NextCheckpointIndex);
+
+	return 2.f * (progress[myRacer] - progress[opponentRacer]) - interceptor.Distance(opponentTarget);
+}
+
+inline float MonteCarloSearchEngine::Play(const TurnContext& aContext, const Solution& aSolution, int aDepth, GameState* aStates) const
+{
+	const Simulator& simulator = *aContext.TurnSimulator;
+
+	for (int depth = aDepth; depth < Depth; depth++)
+	{
+		GameState& state = aStates[depth + 1];
+		state = aStates[depth];
+
+		PodMove moves[4] = { aSolution.Moves[depth][0], aSolution.Moves[depth][1] };
+		for (int i = 2; i < 4; i++)
+		{
+			moves[i] = simulator.StraightMove(state.Pods[i]);
+		}
+		simulator.PlayTurn(state, moves);
+	}
+
+	return EvaluateState(aContext, aStates[Depth]);
+}
+
+inline void MonteCarloSearchEngine::ShiftBest(const TurnContext& aContext)
+{
+	// Last turn best sequence, shifted by the turn that has been played, unless pondering already did it
+	if (_mPondered == false)
+	{
+		std::copy(&_mBest.Moves[1][0], &_mBest.Moves[0][0] + Depth * 2, &_mBest.Moves[0][0]);
+	}
+	_mPondered = false;
+
+	_mStates[0] = aContext.State;
+	_mBest.Score = Play(aContext, _mBest, 0, _mStates);
+}
+
+inline bool MonteCarloSearchEngine::Improve(const TurnContext& aContext, float aAmplitude)
+{
+	// Moves before the mutated turn are unchanged, so are the states, only the end of the sequence is played again
+	GameState candidateStates[Depth + 1];
+	Solution candidate = _mBest;
+	const int depth = Mutate(candidate, aAmplitude);
+	candidateStates[depth] = _mStates[depth];
+	candidate.Score = Play(aContext, candidate, depth, candidateStates);
+
+	if (candidate.Score <= _mBest.Score)
+		return false;
+
+	_mBest = candidate;
+	std::copy(candidateStates + depth + 1, candidateStates + Depth + 1, _mStates + depth + 1);
+	return true;
+}
+
+inline void MonteCarloSearchEngine::Prepare(const TurnContext& aContext)
+{
+	GameState greedyStates[Depth + 1];
+	greedyStates[0] = aContext.State;
+	Solution greedy;
+	BuildGreedySolution(aContext, greedy);
+	greedy.Score = Play(aContext, greedy, 0, greedyStates);
+
+	if (_mHasBest)
+	{
+		ShiftBest(aContext);
+	}
+
+	if (_mHasBest == false || greedy.Score > _mBest.Score)
+	{
+		_mBest = greedy;
+		std::copy(greedyStates, greedyStates + Depth + 1, _mStates);
+		_mHasBest = true;
+	}
+}
+
+inline void MonteCarloSearchEngine::Adopt(const TurnContext& aContext, const Solution& aSolution)
+{
+	if (aSolution.Score <= _mBest.Score)
+		return;
+
+	_mBest = aSolution;
+	_mStates[0] = aContext.State;
+	Play(aContext, _mBest, 0, _mStates);
+}
+
+inline void MonteCarloSearchEngine::Search(const TurnContext& aContext, const TurnDeadline& aDeadline, TurnAnswer& aAnswer)
+{
+	// The referee let pods rotate freely during the first turn, which the simulator doesn't model
+	if (aContext.State.Turn == 0)
+		return;
+
+	Prepare(aContext);
+	aAnswer.Submit(_mBest.Moves[0][0], _mBest.Moves[0][1], _mBest.Score);
+
+	while (aDeadline.Expired() == false)
+	{
+		if (Improve(aContext, 1.f - aDeadline.Progress()))
+		{
+			aAnswer.Submit(_mBest.Moves[0][0], _mBest.Moves[0][1], _mBest.Score);
+		}
+	}
+}
+
+inline int MonteCarloSearchEngine::Ponder(const TurnContext& aPredicted, const std::atomic<bool>& aStop)
+{
+	if (_mHasBest == false)
+		return 0;
+
+	ShiftBest(aPredicted);
+	_mPondered = true;
+
+	// No idea how long the wait is, mutations stay mid-sized and the turn search narrows them afterwards
+	int candidates = 0;
+	while (aStop.load(std::memory_order_relaxed) == false)
+	{
+		Improve(aPredicted, 0.5f);
+		candidates++;
+	}
+
+	return candidates;
+}
+
+// ==== Parallel Search Engine ====
+
+inline void ParallelSearchEngine::FinishAt(int aEpoch)
+{
+	int lastEpoch = _mLastEpoch.load(std::memory_order_relaxed);
+	while (aEpoch < lastEpoch && _mLastEpoch.compare_exchange_weak(lastEpoch, aEpoch, std::memory_order_relaxed) == false)
+	{
+	}
+}
+
+inline void ParallelSearchEngine::Run(int aWorker, const TurnContext& aContext, const TurnDeadline& aDeadline, ThreadBarrier& aBarrier)
+{
+	using Clock = std::chrono::steady_clock;
+
+	MonteCarloSearchEngine& worker = _mWorkers[aWorker];
+	const int workerCount = Threads();
+	const bool deterministic = (_mDeterministicCandidates > 0);
+	worker.Prepare(aContext);
+
+	int candidates = 0;
+	for (int epoch = 0; ; epoch++)
+	{
+		const int epochCandidates = candidates;
+		if (deterministic)
+		{
+			// The deadline still wins over reproducibility, the turn is cut short rather than late
+			const int epochEnd = std::min(candidates + ExchangeCandidates, _mDeterministicCandidates);
+			bool expired = false;
+			for (; candidates < epochEnd && expired == false; candidates++)
+			{
+				worker.Improve(aContext, 1.f - static_cast<float>(candidates) / _mDeterministicCandidates);
+				expired = (candidates % DeadlineCheckInterval == 0) && aDeadline.Expired();
+			}
+			if (expired)
+			{
+				_mDeadlineCut.store(true, std::memory_order_relaxed);
+			}
+			if (expired || candidates >= _mDeterministicCandidates)
+			{
+				FinishAt(epoch);
+			}
+		}
+		else
+		{
+			const Clock::time_point epochEnd = Clock::now() + std::chrono::milliseconds(ExchangeInterval);
+			while (aDeadline.Expired() == false && Clock::now() < epochEnd)
+			{
+				worker.Improve(aContext, 1.f - aDeadline.Progress());
+				candidates++;
+			}
+			if (aDeadline.Expired())
+			{
+				FinishAt(epoch);
+			}
+		}
+		_mEpochCandidates.fetch_add(candidates - epochCandidates, std::memory_order_relaxed);
+
+		// Every thread asked to finish if needed before the barrier, so all of them agree on stopping after it
+		std::vector<MonteCarloSearchEngine::Solution>& exchange = _mExchange[epoch % 2];
+		exchange[aWorker] = worker.Best();
+		aBarrier.Wait();
+		worker.Adopt(aContext, exchange[(aWorker + workerCount - 1) % workerCount]);
+
+		if (_mLastEpoch.load(std::memory_order_relaxed) <= epoch)
+			break;
+	}
+}
+
+inline void ParallelSearchEngine::Search(const TurnContext& aContext, const TurnDeadline& aDeadline, TurnAnswer& aAnswer)
+{
+	// The referee let pods rotate freely during the first turn, which the simulator doesn't model
+	if (aContext.State.Turn == 0)
+		return;
+
+	ThreadBarrier barrier(Threads());
+	_mLastEpoch.store(std::numeric_limits<int>::max(), std::memory_order_relaxed);
+	_mEpochCandidates.store(0, std::memory_order_relaxed);
+	_mDeadlineCut.store(false, std::memory_order_relaxed);
+
+	// The calling thread is the first worker
+	std::vector<std::thread> threads;
+	for (int i = 1; i < Threads(); i++)
+	{
+		threads.emplace_back([this, i, &aContext, &aDeadline, &barrier]() { Run(i, aContext, aDeadline, barrier); });
+	}
+	Run(0, aContext, aDeadline, barrier);
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	// Ties go to the lowest thread, which keeps deterministic mode deterministic
+	for (const MonteCarloSearchEngine& worker : _mWorkers)
 	{
-		return nextNextCheckpoint.Position();
+		aAnswer.Submit(worker.Best().Moves[0][0], worker.Best().Moves[0][1], worker.Best().Score);
+	}
+	_mCandidates = _mEpochCandidates.load(std::memory_order_relaxed);
+
+	if (_mDeadlineCut.load(std::memory_order_relaxed))
+	{
+		std::cerr << "Warning : deterministic search cut by the deadline after " << _mCandidates << " of "
+			<< static_cast<long long>(_mDeterministicCandidates) * Threads() << " candidates, this turn is not reproducible" << std::endl;
+	}
+}
+
+inline int ParallelSearchEngine::Ponder(const TurnContext& aPredicted, const std::atomic<bool>& aStop)
+{
+	// Only the first worker ponders, the others shift their sequence when the turn starts as usual
+	return _mWorkers[0].Ponder(aPredicted, aStop);
+}
+
+// ==== Turn Scheduler ====
+
+inline bool TurnScheduler::WaitForInput(std::istream& aInput)
+{
+	if (_mTurnStarted)
+		return true;
+
+	// Block until the first byte of the turn is available, the referee clock is already running from there
+	if (aInput.peek() == std::char_traits<char>::eof())
+		return false;
+
+	_mTurnStart = Clock::now();
+	_mTurnStarted = true;
+	return true;
+}
+
+inline TurnDeadline TurnScheduler::Deadline() const
+{
+	const int budget = std::max(0, TurnBudget() - _mSafetyMargin);
+	return TurnDeadline(_mTurnStart, _mTurnStart + std::chrono::milliseconds(budget));
+}
+
+inline void TurnScheduler::Play(TurnEngine* aEngine, const TurnContext& aContext, TurnAnswer& aAnswer)
+{
+	if (aEngine == nullptr)
+		return;
+
+	const TurnDeadline deadline = Deadline();
+	aEngine->Search(aContext, deadline, aAnswer);
+	if (deadline.Overtime() > LateTolerance)
+	{
+		_mLateReturns++;
+	}
+}
+
+inline void TurnScheduler::EndTurn(bool aEngineAnswered)
+{
+	const float elapsed = std::chrono::duration<float, std::milli>(Clock::now() - _mTurnStart).count();
+	const float margin = TurnBudget() - elapsed;
+
+	if (aEngineAnswered == false)
+	{
+		_mFallbacks++;
+	}
+	if (margin < 0.f)
+	{
+		_mOverruns++;
+	}
+	_mMinMargin = std::min(_mMinMargin, margin);
+	_mTotalMargin += margin;
+	_mTurn++;
+	_mTurnStarted = false;
+
+	std::cerr << "Turn " << _mTurn << " : " << elapsed << "ms used, " << margin << "ms left"
+		<< " | late returns " << _mLateReturns
+		<< ", fallbacks " << _mFallbacks
+		<< ", overruns " << _mOverruns
+		<< ", margin min " << _mMinMargin << "ms avg " << (_mTotalMargin / _mTurn) << "ms" << std::endl;
+}
+
+// ==== Ponderer ====
+
+inline void Ponderer::Start(TurnEngine* aEngine, const TurnContext& aContext, const PodMove& aFirstPodMove, const PodMove& aSecondPodMove)
+{
+	if (aEngine == nullptr || Running())
+		return;
+
+	const Simulator& simulator = *aContext.TurnSimulator;
+	_mPredicted = aContext;
+
+	PodMove moves[4] = { aFirstPodMove, aSecondPodMove };
+	for (int i = 2; i < 4; i++)
+	{
+		moves[i] = simulator.StraightMove(_mPredicted.State.Pods[i]);
+	}
+	simulator.PlayTurn(_mPredicted.State, moves);
+
+	_mStop.store(false, std::memory_order_relaxed);
+	_mStart = Clock::now();
+	_mThread = std::thread([this, aEngine]()
+	{
+		_mCandidates.store(aEngine->Ponder(_mPredicted, _mStop), std::memory_order_relaxed);
+	});
+}
+
+inline void Ponderer::Stop()
+{
+	if (Running() == false)
+		return;
+
+	_mStop.store(true, std::memory_order_relaxed);
+	_mThread.join();
+	_mLastTime = std::chrono::duration<float, std::milli>(Clock::now() - _mStart).count();
+	_mStopped = true;
+}
+
+inline void Ponderer::Report(const TurnContext& aActual)
+{
+	if (_mStopped == false)
+		return;
+	_mStopped = false;
+
+	// Our pods are only missed on collisions, opponents as soon as they don't race straight to their checkpoint
+	const int candidates = _mCandidates.load(std::memory_order_relaxed);
+	bool hits[4];
+	for (int i = 0; i < 4; i++)
+	{
+		const PodState& predicted = _mPredicted.State.Pods[i];
+		const PodState& actual = aActual.State.Pods[i];
+		hits[i] = predicted.X == actual.X && predicted.Y == actual.Y && predicted.VX == actual.VX && predicted.VY == actual.VY
+			&& predicted.Angle == actual.Angle && predicted.NextCheckpointIndex == actual.NextCheckpointIndex;
+	}
+	const bool ownHit = hits[0] && hits[1];
+	const bool hit = ownHit && hits[2] && hits[3];
+
+	_mTurns++;
+	_mHits += hit;
+	_mOwnHits += ownHit;
+	_mTotalTime += _mLastTime;
+	_mTotalCandidates += candidates;
+
+	std::cerr << "Ponder : " << _mLastTime << "ms, " << candidates << " candidates, prediction " << (hit ? "hit" : (ownHit ? "own pods hit" : "miss"))
+		<< " | avg " << (_mTotalTime / _mTurns) << "ms " << (_mTotalCandidates / _mTurns) << " candidates"
+		<< ", hits " << _mHits << "/" << _mTurns << ", own pods hits " << _mOwnHits << "/" << _mTurns << std::endl;
+}
+
+// ==== World Estimator ====
+
+inline PodState WorldEstimator::Observe(const Pod& aPod, const PodState& aPrevious) const
+{
+	PodState state = aPrevious;
+	state.X = static_cast<int16_t>(aPod.Position().X);
+	state.Y = static_cast<int16_t>(aPod.Position().Y);
+	state.VX = static_cast<int16_t>(aPod.Speed().X);
+	state.VY = static_cast<int16_t>(aPod.Speed().Y);
+	state.Angle = static_cast<int16_t>(FixedTrigonometry::NormalizeAngle(aPod.Angle()));
+	state.NextCheckpointIndex = static_cast<uint8_t>(aPod.NextCheckpointIndex());
+	return state;
+}
+
+inline int WorldEstimator::EstimateThrust(const PodState& aPrevious, const PodState& aObserved) const
+{
+	// Without collision, the displacement is the previous speed plus the thrust along the new angle
+	const double pi = std::acos(-1.0);
+	const double angle = aObserved.Angle * pi / 180.0;
+	const double thrust = (aObserved.X - aPrevious.X - aPrevious.VX) * std::cos(angle) + (aObserved.Y - aPrevious.Y - aPrevious.VY) * std::sin(angle);
+	return static_cast<int>(std::lround(thrust));
+}
+
+inline int WorldEstimator::BuildCandidates(const PodState& aPrevious, const PodState& aObserved, PodMove* aCandidates) const
+{
+	int count = 0;
+	auto add = [&](int16_t aThrust)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			if (aCandidates[i].Thrust == aThrust)
+				return;
+		}
+		aCandidates[count++] = PodMove{ 0, aThrust };
+	};
+
+	// Most likely explanation first, it wins ties
+	const int thrust = EstimateThrust(aPrevious, aObserved);
+	if (aPrevious.ShieldCooldown > 0)
+	{
+		add(0);
 	}
 	else
-		return aSimulationEntry.checkpointManager[pod.NextCheckpointIndex()].Position();
+	{
+		add(static_cast<int16_t>(std::clamp(thrust, 0, Simulator::MaxThrust)));
+		if (aPrevious.BoostAvailable)
+			add(PodMove::Boost);
+		add(0);
+		add(Simulator::MaxThrust);
+	}
+	add(PodMove::Shield);
+	return count;
+}
+
+inline void WorldEstimator::RecordMoves(const PodMove& aFirstPodMove, const PodMove& aSecondPodMove)
+{
+	_mLastMoves[0] = aFirstPodMove;
+	_mLastMoves[1] = aSecondPodMove;
+}
+
+inline void WorldEstimator::Update(std::vector<Pod>& aMyPods, std::vector<Pod>& aOpponentPods)
+{
+	const Pod* pods[4] = { &aMyPods[0], &aMyPods[1], &aOpponentPods[0], &aOpponentPods[1] };
+	const int checkpointCount = _mSimulator->NumberOfCheckpoint();
+
+	PodState observed[4];
+	for (int i = 0; i < 4; i++)
+	{
+		observed[i] = Observe(*pods[i], _mState.Pods[i]);
+	}
+
+	if (_mInitialized == false)
+	{
+		for (PodState& state : observed)
+		{
+			state.CheckpointsPassed = 0;
+			state.ShieldCooldown = 0;
+			state.BoostAvailable = 1;
+			state.Shielded = 0;
+		}
+		_mState.TimeLeft[0] = Simulator::Timeout;
+		_mState.TimeLeft[1] = Simulator::Timeout;
+		_mState.Turn = 0;
+		_mInitialized = true;
+	}
+	else
+	{
+		// -- Checkpoint counters, from the index progression so that a lap is never missed
+		bool passed[2] = { false, false };
+		for (int i = 0; i < 4; i++)
+		{
+			const int progress = (observed[i].NextCheckpointIndex - _mState.Pods[i].NextCheckpointIndex + checkpointCount) % checkpointCount;
+			observed[i].CheckpointsPassed = static_cast<uint16_t>(_mState.Pods[i].CheckpointsPassed + progress);
+			passed[i / 2] |= progress > 0;
+		}
+		for (int player = 0; player < 2; player++)
+		{
+			_mState.TimeLeft[player] = passed[player] ? Simulator::Timeout : _mState.TimeLeft[player] - 1;
+		}
+
+		// -- Replaying the turn under each opponent orders combination, angles are taken as observed after rotation
+		PodMove candidates[2][5];
+		int candidatesCount[2];
+		for (int opponent = 0; opponent < 2; opponent++)
+		{
+			candidatesCount[opponent] = BuildCandidates(_mState.Pods[2 + opponent], observed[2 + opponent], candidates[opponent]);
+		}
+
+		PodState start[4];
+		for (int i = 0; i < 4; i++)
+		{
+			start[i] = _mState.Pods[i];
+			start[i].Angle = observed[i].Angle;
+		}
+
+		PodState best[4];
+		int64_t bestError = std::numeric_limits<int64_t>::max();
+		for (int first = 0; first < candidatesCount[0]; first++)
+		{
+			for (int second = 0; second < candidatesCount[1]; second++)
+			{
+				PodMove moves[4] = { _mLastMoves[0], _mLastMoves[1], candidates[0][first], candidates[1][second] };
+				moves[0].Rotation = 0;
+				moves[1].Rotation = 0;
+
+				PodState simulated[4];
+				std::copy(start, start + 4, simulated);
+				_mSimulator->PlayTurn(simulated, moves, 4);
+
+				int64_t error = 0;
+				for (int i = 0; i < 4; i++)
+				{
+					const int64_t dx = simulated[i].X - observed[i].X;
+					const int64_t dy = simulated[i].Y - observed[i].Y;
+					const int64_t dvx = simulated[i].VX - observed[i].VX;
+					const int64_t dvy = simulated[i].VY - observed[i].VY;
+					error += dx * dx + dy * dy + dvx * dvx + dvy * dvy;
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					std::copy(simulated, simulated + 4, best);
+				}
+			}
+		}
+
+		// -- Hidden resources come from the best explanation, everything else is observed
+		for (int i = 0; i < 4; i++)
+		{
+			if (i >= 2 && best[i].BoostAvailable == 0 && _mState.Pods[i].BoostAvailable)
+			{
+				_mOpponentBoostTurn[i - 2] = _mState.Turn;
+				std::cerr << "Opponent " << (i - 2) << " used BOOST" << std::endl;
+			}
+			if (i >= 2 && best[i].Shielded)
+			{
+				_mOpponentShields[i - 2]++;
+				std::cerr << "Opponent " << (i - 2) << " used SHIELD" << std::endl;
+			}
+
+			observed[i].BoostAvailable = best[i].BoostAvailable;
+			observed[i].ShieldCooldown = best[i].ShieldCooldown;
+			observed[i].Shielded = 0;
+		}
+		_mState.Turn++;
+	}
+
+	std::copy(observed, observed + 4, _mState.Pods);
+
+	aMyPods[0].UpdateFromEstimation(_mState.Pods[0], checkpointCount);
+	aMyPods[1].UpdateFromEstimation(_mState.Pods[1], checkpointCount);
+	aOpponentPods[0].UpdateFromEstimation(_mState.Pods[2], checkpointCount);
+	aOpponentPods[1].UpdateFromEstimation(_mState.Pods[3], checkpointCount);
+}
+
+inline void WorldEstimator::FillContext(TurnContext& aContext) const
+{
+	aContext.State = _mState;
+	aContext.TurnSimulator = _mSimulator;
+}
+
+// ==== Self-play ====
+
+inline void MapGenerator::Generate(std::vector<Vector2<int>>& aCheckpoints, int& aLaps)
+{
+	aLaps = Laps;
+	const int count = _mRandom.Range(MinCheckpoints, MaxCheckpoints);
+	const int border = Simulator::CheckpointRadius;
+	aCheckpoints.clear();
+	while (static_cast<int>(aCheckpoints.size()) < count)
+	{
+		const Vector2<int> candidate(_mRandom.Range(border, Width - border), _mRandom.Range(border, Height - border));
+		const bool farEnough = std::all_of(aCheckpoints.begin(), aCheckpoints.end(),
+			[&](const Vector2<int>& aOther) { return aOther.DistanceSqr(candidate) >= MinSeparation * MinSeparation; });
+		if (farEnough)
+			aCheckpoints.push_back(candidate);
+	}
+}
+
+inline MapCategory MapGenerator::Classify(const std::vector<Vector2<int>>& aCheckpoints)
+{
+	const int count = static_cast<int>(aCheckpoints.size());
+	const float hairpinCosine = std::cos(HairpinTurn * std::acos(-1.f) / 180.f);
+	bool longLeg = false;
+
+	for (int i = 0; i < count; i++)
+	{
+		const Vector2<int>& previous = aCheckpoints[(i + count - 1) % count];
+		const Vector2<int>& current = aCheckpoints[i];
+		const Vector2<int>& next = aCheckpoints[(i + 1) % count];
+
+		// Turning by more than HairpinTurn means legs directions form a cosine below the hairpin one
+		const Vector2<float> in = (current - previous).Normalize();
+		const Vector2<float> out = (next - current).Normalize();
+		if (in.Dot(out) < hairpinCosine)
+			return MapCategory::Hairpin;
+
+		longLeg = longLeg || current.Distance(next) >= LongLegLength;
+	}
+
+	return longLeg ? MapCategory::LongLeg : MapCategory::Easy;
+}
+
+inline const char* MapGenerator::CategoryName(MapCategory aCategory)
+{
+	switch (aCategory)
+	{
+	case MapCategory::Easy: return "easy";
+	case MapCategory::Hairpin: return "hairpin";
+	case MapCategory::LongLeg: return "long-leg";
+	}
+	return "unknown";
+}
+
+// ==== Map Corpus ====
+
+inline void MapCorpus::Map(int aIndex, std::vector<Vector2<int>>& aCheckpoints, int& aLaps)
+{
+	// Maps are drawn until one falls in the category, the seed only depends on the version and the index
+	const MapCategory category = Category(aIndex);
+	MapGenerator generator(static_cast<uint64_t>(Version) * 0x9E3779B97F4A7C15ull + static_cast<uint64_t>(aIndex) + 1);
+	do
+	{
+		generator.Generate(aCheckpoints, aLaps);
+	} while (MapGenerator::Classify(aCheckpoints) != category);
+}
+
+inline void MapCorpus::Report(std::ostream& aOutput)
+{
+	int maps[CategoryCount] = {};
+	int checkpoints[CategoryCount] = {};
+	double legs[CategoryCount] = {};
+	uint64_t checksum = 0xCBF29CE484222325ull;
+
+	std::vector<Vector2<int>> map;
+	int laps;
+	for (int i = 0; i < Size; i++)
+	{
+		Map(i, map, laps);
+		const int category = static_cast<int>(Category(i));
+		maps[category]++;
+		checkpoints[category] += static_cast<int>(map.size());
+		for (size_t c = 0; c < map.size(); c++)
+		{
+			legs[category] += map[c].Distance(map[(c + 1) % map.size()]);
+			// FNV-1a over coordinates
+			checksum = (checksum ^ static_cast<uint64_t>(map[c].X)) * 0x100000001B3ull;
+			checksum = (checksum ^ static_cast<uint64_t>(map[c].Y)) * 0x100000001B3ull;
+		}
+	}
+
+	aOutput << "Map corpus v" << Version << " : " << Size << " maps, checksum " << std::hex << checksum << std::dec << "\n";
+	for (int category = 0; category < CategoryCount; category++)
+	{
+		aOutput << "  " << MapGenerator::CategoryName(static_cast<MapCategory>(category)) << " : " << maps[category] << " maps, "
+			<< static_cast<float>(checkpoints[category]) / maps[category] << " checkpoints, "
+			<< legs[category] / checkpoints[category] << " average leg\n";
+	}
+}
+
+// ==== Bot Process ====
+
+inline BotProcess::BotProcess(const std::string& aCommand) :
+	_mPid(-1),
+	_mInput(-1),
+	_mOutput(-1)
+{
+	// Close on exec, so that bots started by other games never inherit these pipes
+	int input[2];
+	int output[2];
+	if (pipe2(input, O_CLOEXEC) != 0)
+		return;
+	if (pipe2(output, O_CLOEXEC) != 0)
+	{
+		close(input[0]);
+		close(input[1]);
+		return;
+	}
+
+	_mPid = fork();
+	if (_mPid == 0)
+	{
+		dup2(input[0], STDIN_FILENO);
+		dup2(output[1], STDOUT_FILENO);
+		const int devNull = open("/dev/null", O_WRONLY);
+		dup2(devNull, STDERR_FILENO);
+		execl("/bin/sh", "sh", "-c", aCommand.c_str(), static_cast<char*>(nullptr));
+		_exit(127);
+	}
+
+	close(input[0]);
+	close(output[1]);
+	_mInput = input[1];
+	_mOutput = output[0];
+}
+
+inline BotProcess::~BotProcess()
+{
+	if (_mInput >= 0)
+		close(_mInput);
+	if (_mOutput >= 0)
+		close(_mOutput);
+	if (_mPid > 0)
+	{
+		kill(_mPid, SIGKILL);
+		waitpid(_mPid, nullptr, 0);
+	}
+}
+
+inline bool BotProcess::Send(const std::string& aText)
+{
+	size_t written = 0;
+	while (_mInput >= 0 && written < aText.size())
+	{
+		const ssize_t result = write(_mInput, aText.data() + written, aText.size() - written);
+		if (result <= 0)
+			return false;
+		written += static_cast<size_t>(result);
+	}
+	return written == aText.size();
+}
+
+inline bool BotProcess::Receive(std::string& aLine, int aTimeout)
+{
+	while (_mOutput >= 0)
+	{
+		const size_t endOfLine = _mBuffer.find('\n');
+		if (endOfLine != std::string::npos)
+		{
+			aLine = _mBuffer.substr(0, endOfLine);
+			_mBuffer.erase(0, endOfLine + 1);
+			return true;
+		}
+
+		pollfd descriptor = { _mOutput, POLLIN, 0 };
+		if (poll(&descriptor, 1, aTimeout) <= 0)
+			return false;
+
+		char chunk[256];
+		const ssize_t result = read(_mOutput, chunk, sizeof(chunk));
+		if (result <= 0)
+			return false;
+		_mBuffer.append(chunk, static_cast<size_t>(result));
+	}
+	return false;
+}
+
+// ==== Local Referee ====
+
+inline LocalReferee::LocalReferee(const std::vector<Vector2<int>>& aCheckpoints, int aLaps, int aTimeTolerance) :
+	_mLaps(aLaps),
+	_mTimeTolerance(std::max(0, aTimeTolerance))
+{
+	_mCheckpointManager.Build(aCheckpoints);
+	_mSimulator = Simulator(_mCheckpointManager);
+}
+
+inline bool LocalReferee::ReadMoves(BotProcess& aBot, std::chrono::steady_clock::time_point aDeadline, const GameState& aState, int aPlayer,
+	PodMove* aMoves, bool aFirstTurn, GameState& aNextState, bool& aTimedOut) const
+{
+	aTimedOut = false;
+	for (int i = 0; i < 2; i++)
+	{
+		const int index = 2 * aPlayer + i;
+		const auto left = std::chrono::ceil<std::chrono::milliseconds>(aDeadline - std::chrono::steady_clock::now()).count();
+		std::string line;
+		if (aBot.Receive(line, static_cast<int>(std::max<long long>(0, left))) == false)
+		{
+			aTimedOut = std::chrono::steady_clock::now() >= aDeadline;
+			return false;
+		}
+
+		std::istringstream stream(line);
+		int x, y;
+		std::string thrust;
+		if (!(stream >> x >> y >> thrust))
+			return false;
+
+		PodMove& move = aMoves[index];
+		if (thrust == "BOOST")
+			move.Thrust = PodMove::Boost;
+		else if (thrust == "SHIELD")
+			move.Thrust = PodMove::Shield;
+		else
+			move.Thrust = static_cast<int16_t>(std::clamp(std::atoi(thrust.c_str()), 0, Simulator::MaxThrust));
+
+		// The first turn, pods can face any direction
+		if (aFirstTurn)
+		{
+			const double pi = std::acos(-1.0);
+			const PodState& pod = aState.Pods[index];
+			const int angle = static_cast<int>(std::lround(std::atan2(y - pod.Y, x - pod.X) * 180.0 / pi));
+			aNextState.Pods[index].Angle = static_cast<int16_t>(FixedTrigonometry::NormalizeAngle(angle));
+			move.Rotation = 0;
+		}
+		else
+		{
+			move.Rotation = static_cast<int16_t>(Simulator::RotationToward(aState.Pods[index], { x, y }));
+		}
+	}
+	return true;
+}
+
+inline GameState LocalReferee::StartState(const Simulator& aSimulator)
+{
+	// Pods lined up on the first checkpoint, perpendicular to the way to the second one
+	GameState state = {};
+	const Vector2<int> start = aSimulator.CheckpointPosition(0);
+	const Vector2<float> direction = (aSimulator.CheckpointPosition(1) - start).Normalize();
+	const int offsets[4] = { -1500, 500, -500, 1500 };
+	for (int i = 0; i < 4; i++)
+	{
+		PodState& pod = state.Pods[i];
+		pod.X = static_cast<int16_t>(start.X + std::lround(-direction.Y * offsets[i]));
+		pod.Y = static_cast<int16_t>(start.Y + std::lround(direction.X * offsets[i]));
+		pod.NextCheckpointIndex = 1;
+		pod.BoostAvailable = 1;
+	}
+	state.TimeLeft[0] = Simulator::Timeout;
+	state.TimeLeft[1] = Simulator::Timeout;
+	return state;
+}
+
+inline int LocalReferee::Play(const std::string& aFirstCommand, const std::string& aSecondCommand, bool& aFirstTimedOut, bool& aSecondTimedOut) const
+{
+	aFirstTimedOut = false;
+	aSecondTimedOut = false;
+	const int checkpointCount = _mSimulator.NumberOfCheckpoint();
+	const int checkpointsToWin = _mLaps * checkpointCount;
+	GameState state = StartState(_mSimulator);
+
+	BotProcess bots[2] = { BotProcess(aFirstCommand), BotProcess(aSecondCommand) };
+
+	std::ostringstream initialization;
+	initialization << _mLaps << "\n" << checkpointCount << "\n";
+	for (int i = 0; i < checkpointCount; i++)
+	{
+		initialization << _mSimulator.CheckpointPosition(i).X << " " << _mSimulator.CheckpointPosition(i).Y << "\n";
+	}
+	for (BotProcess& bot : bots)
+	{
+		bot.Send(initialization.str());
+	}
+
+	for (int turn = 0; turn < MaxTurns; turn++)
+	{
+		// -- Both bots think at the same time, each one seeing its own pods first
+		for (int player = 0; player < 2; player++)
+		{
+			std::ostringstream input;
+			for (int i = 0; i < 4; i++)
+			{
+				const PodState& pod = state.Pods[(2 * player + i) % 4];
+				input << pod.X << " " << pod.Y << " " << pod.VX << " " << pod.VY << " " << pod.Angle << " " << int(pod.NextCheckpointIndex) << "\n";
+			}
+			bots[player].Send(input.str());
+		}
+
+		// -- Both clocks started with the input, whoever is read first
+		const int budget = ((turn == 0) ? (TurnScheduler::FirstTurnBudget) : (TurnScheduler::NextTurnsBudget)) + _mTimeTolerance;
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(budget);
+		PodMove moves[4];
+		GameState next = state;
+		bool answered[2];
+		bool timedOut[2];
+		for (int player = 0; player < 2; player++)
+		{
+			answered[player] = ReadMoves(bots[player], deadline, state, player, moves, turn == 0, next, timedOut[player]);
+		}
+		aFirstTimedOut = timedOut[0];
+		aSecondTimedOut = timedOut[1];
+		if (answered[0] == false || answered[1] == false)
+			return (answered[0] == answered[1]) ? (-1) : (answered[0] ? 0 : 1);
+
+		_mSimulator.PlayTurn(next, moves);
+		state = next;
+
+		const bool firstFinished = std::max(state.Pods[0].CheckpointsPassed, state.Pods[1].CheckpointsPassed) >= checkpointsToWin;
+		const bool secondFinished = std::max(state.Pods[2].CheckpointsPassed, state.Pods[3].CheckpointsPassed) >= checkpointsToWin;
+		if (firstFinished || secondFinished)
+			return (firstFinished && secondFinished) ? (-1) : (firstFinished ? 0 : 1);
+
+		if (state.TimeLeft[0] <= 0 || state.TimeLeft[1] <= 0)
+			return (state.TimeLeft[0] <= 0 && state.TimeLeft[1] <= 0) ? (-1) : (state.TimeLeft[0] <= 0 ? 1 : 0);
+	}
+
+	return -1;
+}
+
+// ==== Sequential Probability Ratio Test ====
+
+inline void SequentialProbabilityRatioTest::AddPair(int aFirstResult, int aSecondResult)
+{
+	for (const int result : { aFirstResult, aSecondResult })
+	{
+		if (result > 0)
+			_mWins++;
+		else if (result < 0)
+			_mLosses++;
+		else
+			_mDraws++;
+	}
+	_mPairs[aFirstResult + aSecondResult + 2]++;
+}
+
+inline void SequentialProbabilityRatioTest::PairScore(double& aMean, double& aVariance) const
+{
+	// Score of a pair per game, from 0 to 1 by quarters
+	const double pairs = Pairs();
+	aMean = 0.0;
+	for (int points = 0; points < 5; points++)
+	{
+		aMean += _mPairs[points] * (points / 4.0);
+	}
+	aMean /= std::max(1.0, pairs);
+
+	// Half a lost pair and half a won pair are added to the variance only, so that one-sided results still converge
+	aVariance = 0.5 * aMean * aMean + 0.5 * (1.0 - aMean) * (1.0 - aMean);
+	for (int points = 0; points < 5; points++)
+	{
+		aVariance += _mPairs[points] * (points / 4.0 - aMean) * (points / 4.0 - aMean);
+	}
+	aVariance /= (pairs + 1.0);
 }
 
-inline SimulationResult RacerPodStrategy::Compute(Pod& pod, const SimulationEntry& aSimulationEntry)
+inline double SequentialProbabilityRatioTest::LogLikelihoodRatio() const
 {
-	pod.SetTarget(ComputeTarget(pod, aSimulationEntry));
-	ComputeThrust(pod, aSimulationEntry);
-	return SimulationResult(pod.BoostUsed(), pod.ShieldUsed(), pod.Target().X, pod.Target().Y, pod.Thrust());
+	const double pairs = Pairs();
+	if (pairs == 0)
+		return 0.0;
+
+	double mean;
+	double variance;
+	PairScore(mean, variance);
 
+	const double score0 = ExpectedScore(_mElo0);
+	const double score1 = ExpectedScore(_mElo1);
+	return pairs * (score1 - score0) * (2.0 * mean - score0 - score1) / (2.0 * variance);
 }
 
-// == Interceptor Pod Strategy
+inline int SequentialProbabilityRatioTest::Decision() const
+{
+	const double llr = LogLikelihoodRatio();
+	if (llr >= UpperBound())
+		return 1;
+	if (llr <= LowerBound())
+		return -1;
+	return 0;
+}
 
-inline Vector2<int> InterceptorPodStrategy::ComputeTarget(Pod& pod, const SimulationEntry& aSimulationEntry)
+inline void SequentialProbabilityRatioTest::Report(std::ostream& aOutput) const
 {
-	Vector2<int> target = { 0, 0 };
+	double mean;
+	double variance;
+	PairScore(mean, variance);
+	const double deviation = std::sqrt(variance / std::max(1, Pairs()));
+	const auto elo = [](double aScore) { return -400.0 * std::log10(1.0 / std::clamp(aScore, 1e-3, 1.0 - 1e-3) - 1.0); };
+
+	aOutput << "Games " << Games() << " : B wins " << _mWins << ", A wins " << _mLosses << ", draws " << _mDraws << "\n";
+	aOutput << "Pairs " << Pairs() << " by points of B : 0 " << _mPairs[0] << ", 0.5 " << _mPairs[1] << ", 1 " << _mPairs[2]
+		<< ", 1.5 " << _mPairs[3] << ", 2 " << _mPairs[4] << "\n";
+	aOutput << "Lost on time : A " << _mTimeouts[0] << ", B " << _mTimeouts[1] << "\n";
+	aOutput << "Elo B - A : " << std::showpos << elo(mean) << std::noshowpos
+		<< " [" << elo(mean - 1.96 * deviation) << ", " << elo(mean + 1.96 * deviation) << "] (95%)\n";
+	aOutput << "LLR " << LogLikelihoodRatio() << " [" << LowerBound() << ", " << UpperBound() << "]"
+		<< " for elo0 " << _mElo0 << ", elo1 " << _mElo1 << "\n";
+}
 
-	Pod& opponent = aSimulationEntry.opponentPods[aSimulationEntry.indexRacerOpponent];
-	Vector2<int> opponentTarget = aSimulationEntry.checkpointManager[opponent.NextCheckpointIndex()].Position();
-	Vector2<int> opponentDirection = (opponentTarget - pod.Position());
-	Vector2<int> direction = (opponent.Position() - pod.Position());
+int RunSprt(const SprtConfiguration& aConfiguration)
+{
+	// A bot dying while we write to it must not kill the comparison
+	signal(SIGPIPE, SIG_IGN);
 
-	bool canReachOpponentRacer = [&]() -> bool
+	// Bots are timed on the wall clock, sharing cores makes them lose on time or search less than on the platform
+	const int bots = 2 * std::max(1, aConfiguration.Threads);
+	const int cores = static_cast<int>(std::thread::hardware_concurrency());
+	if (bots > cores)
 	{
-		// If dot product return a value higher than 0, it's mean they face the same direction
-		// And pushing the opponentRacer would not be efficient
-		if (direction.Dot(opponentDirection) > 0)
-			return false;
+		std::cerr << "Warning : " << bots << " bots play at once on " << cores << " cores, their turn budgets are shared" << std::endl;
+	}
+	else if (2 * bots > cores)
+	{
+		std::cerr << "Warning : " << bots << " bots play at once on " << cores << " cores, pondering bots share them" << std::endl;
+	}
 
-		// If opponent pod is closer to his target than our interceptor, we can't reach it before him
-		if (pod.Position().DistanceSqr(opponentTarget) > opponent.Position().DistanceSqr(opponentTarget))
-			return false;
+	SequentialProbabilityRatioTest test(aConfiguration.Elo0, aConfiguration.Elo1, aConfiguration.Alpha, aConfiguration.Beta);
+	// Result of the game played first in each pair, until the other one ends
+	std::map<int, int> pendingPairs;
+	std::mutex mutex;
+	std::atomic<int> nextGame(0);
+	std::atomic<bool> decided(false);
 
-		return true;
-	}();
+	auto worker = [&]()
+	{
+		while (decided == false)
+		{
+			// Games go by pair on the same map, each build playing both sides
+			const int game = nextGame++;
+			if (game >= aConfiguration.MaxGames)
+				return;
+
+			int laps;
+			std::vector<Vector2<int>> checkpoints;
+			MapCorpus::Map((aConfiguration.FirstMap + game / 2) % MapCorpus::Size, checkpoints, laps);
+
+			const LocalReferee referee(checkpoints, laps, aConfiguration.TimeTolerance);
+			const bool swapped = (game % 2) == 1;
+			bool timedOutA;
+			bool timedOutB;
+			const int winner = swapped
+				? referee.Play(aConfiguration.CommandB, aConfiguration.CommandA, timedOutB, timedOutA)
+				: referee.Play(aConfiguration.CommandA, aConfiguration.CommandB, timedOutA, timedOutB);
+			const int result = (winner < 0) ? (0) : (((winner == 1) != swapped) ? (1) : (-1));
+
+			std::lock_guard<std::mutex> lock(mutex);
+			if (decided)
+				return;
+			test.AddTimeouts(timedOutA, timedOutB);
+			if (timedOutA || timedOutB)
+			{
+				std::cerr << "Game " << game << " lost on time by " << (timedOutA ? (timedOutB ? "A and B" : "A") : "B") << std::endl;
+			}
+			const auto pending = pendingPairs.find(game / 2);
+			if (pending == pendingPairs.end())
+			{
+				pendingPairs[game / 2] = result;
+				continue;
+			}
+			test.AddPair(pending->second, result);
+			pendingPairs.erase(pending);
+			if (test.Pairs() % 5 == 0)
+			{
+				std::cerr << "After " << test.Pairs() << " pairs, LLR " << test.LogLikelihoodRatio() << std::endl;
+			}
+			if (test.Decision() != 0)
+			{
+				decided = true;
+			}
+		}
+	};
 
-	if (canReachOpponentRacer)
+	std::vector<std::thread> threads;
+	for (int i = 0; i < std::max(1, aConfiguration.Threads); i++)
 	{
-		return opponent.Position() + opponent.Speed()* 3.f;
+		threads.emplace_back(worker);
 	}
-	// Because our interceptor is not able to reach the opponent pod at this stage, we'll check where we can wait it
-	// To do it, we'll check checkpoint by checkpoint, adding distance separating each other in a quite rough computation
-	// And stop when we see that our pod can reach it before opponent pod
-	float opponentDistance = 0;
-	Vector2<int> opponentCheckpointPositionToReach = opponent.Position();
-	for (int i = 0; i < aSimulationEntry.checkpointManager.NumberOfCheckpoint(); i++)
+	for (std::thread& thread : threads)
 	{
-		int nextCheckpointIndex = (opponent.NextCheckpointIndex() + 1) % (aSimulationEntry.checkpointManager.NumberOfCheckpoint());
-		Vector2<int> nextCheckpointPosition = aSimulationEntry.checkpointManager[nextCheckpointIndex].Position();
+		thread.join();
+	}
 
-		opponentDistance += opponentCheckpointPositionToReach.Distance(nextCheckpointPosition);
-		float podDistance = pod.Position().Distance(nextCheckpointPosition);
+	std::cout << "A : " << aConfiguration.CommandA << "\n" << "B : " << aConfiguration.CommandB << "\n"
+		<< "Maps : corpus v" << MapCorpus::Version << " from map " << aConfiguration.FirstMap << "\n";
+	test.Report(std::cout);
+	switch (test.Decision())
+	{
+	case 1: std::cout << "H1 accepted : B is at least " << aConfiguration.Elo1 << " Elo better" << std::endl; break;
+	case -1: std::cout << "H0 accepted : B is not " << aConfiguration.Elo1 << " Elo better" << std::endl; break;
+	default: std::cout << "Inconclusive after " << test.Games() << " games" << std::endl; break;
+	}
+	return 0;
+}
 
-		opponentCheckpointPositionToReach = nextCheckpointPosition;
-		if (podDistance < opponentDistance)
-			break;
+// ==== Reference Simulator ====
+
+inline ReferenceSimulator::ReferencePod ReferenceSimulator::FromState(const PodState& aPod)
+{
+	ReferencePod pod;
+	pod.X = aPod.X;
+	pod.Y = aPod.Y;
+	pod.VX = aPod.VX;
+	pod.VY = aPod.VY;
+	pod.Angle = aPod.Angle;
+	pod.NextCheckpointIndex = aPod.NextCheckpointIndex;
+	pod.CheckpointsPassed = aPod.CheckpointsPassed;
+	pod.ShieldCooldown = aPod.ShieldCooldown;
+	pod.BoostAvailable = aPod.BoostAvailable != 0;
+	pod.Shielded = aPod.Shielded != 0;
+	return pod;
+}
+
+inline bool ReferenceSimulator::Matches(const ReferencePod& aReference, const PodState& aPod)
+{
+	return aReference.X == aPod.X && aReference.Y == aPod.Y && aReference.VX == aPod.VX && aReference.VY == aPod.VY
+		&& aReference.Angle == aPod.Angle && aReference.NextCheckpointIndex == aPod.NextCheckpointIndex
+		&& aReference.CheckpointsPassed == aPod.CheckpointsPassed;
+}
+
+inline void ReferenceSimulator::Move(ReferencePod& aPod, double aTime) const
+{
+	const Vector2<int>& checkpoint = _mSimulator.CheckpointPosition(aPod.NextCheckpointIndex);
+	const double ex = checkpoint.X - aPod.X;
+	const double ey = checkpoint.Y - aPod.Y;
+	const double sx = aPod.VX * aTime;
+	const double sy = aPod.VY * aTime;
+	const double radiusSqr = double(Simulator::CheckpointRadius) * Simulator::CheckpointRadius;
+
+	const double dotStart = ex * sx + ey * sy;
+	const double segmentSqr = sx * sx + sy * sy;
+	double distanceSqr;
+	if (dotStart <= 0.0 || segmentSqr == 0.0)
+		distanceSqr = ex * ex + ey * ey;
+	else if (dotStart >= segmentSqr)
+		distanceSqr = (ex - sx) * (ex - sx) + (ey - sy) * (ey - sy);
+	else
+		distanceSqr = ex * ex + ey * ey - dotStart * dotStart / segmentSqr;
+
+	if (distanceSqr < radiusSqr)
+	{
+		aPod.NextCheckpointIndex = (aPod.NextCheckpointIndex + 1) % _mSimulator.NumberOfCheckpoint();
+		aPod.CheckpointsPassed++;
 	}
 
-	return opponentCheckpointPositionToReach;
+	aPod.X += sx;
+	aPod.Y += sy;
 }
 
-inline bool InterceptorPodStrategy::BeneficialCollision(const Pod& podA, const Pod& podB)
+inline int ReferenceSimulator::PlayTurn(ReferencePod* aPods, const PodMove* aMoves, int aPodCount) const
 {
-	// Dot product of two normalized vectors gives a value between -1 and 1
-	// 0 = Vectors are perpendicular
-	// 1 = Vectors are parallel (facing the same direction)
-	// -1 = Vectors are anti-parallel (facing the opposite direction)
-	// 
-	// 0.5 seems a reasonable value, meaning the pod will push his target into a quite undesirable position
-	const Vector2<float> podADirection = (podA.Target() - podA.Position()).Normalize();
-	const Vector2<float> podBDirection = (podB.Target() - podB.Position()).Normalize();
-	return podADirection.Dot(podBDirection) < 0.5f;
+	const double pi = std::acos(-1.0);
+
+	for (int i = 0; i < aPodCount; i++)
+	{
+		ReferencePod& pod = aPods[i];
+		pod.Angle = FixedTrigonometry::NormalizeAngle(pod.Angle + std::clamp<int>(aMoves[i].Rotation, -Simulator::MaxRotation, Simulator::MaxRotation));
+		pod.Shielded = false;
+
+		int thrust = aMoves[i].Thrust;
+		if (thrust == PodMove::Shield)
+		{
+			pod.Shielded = true;
+			pod.ShieldCooldown = Simulator::ShieldCooldown;
+			thrust = 0;
+		}
+		else if (pod.ShieldCooldown > 0)
+		{
+			pod.ShieldCooldown--;
+			thrust = 0;
+		}
+		else if (thrust == PodMove::Boost)
+		{
+			thrust = pod.BoostAvailable ? Simulator::BoostThrust : Simulator::MaxThrust;
+			pod.BoostAvailable = false;
+		}
+
+		pod.VX += std::cos(pod.Angle * pi / 180.0) * thrust;
+		pod.VY += std::sin(pod.Angle * pi / 180.0) * thrust;
+	}
+
+	int collisions = 0;
+	double remainingTime = 1.0;
+	int lastPodA = -1;
+	int lastPodB = -1;
+	while (true)
+	{
+		double firstTime = remainingTime;
+		int firstPodA = -1;
+		int firstPodB = -1;
+		for (int i = 0; i < aPodCount; i++)
+		{
+			for (int j = i + 1; j < aPodCount; j++)
+			{
+				if (i == lastPodA && j == lastPodB)
+					continue;
+
+				const double px = aPods[j].X - aPods[i].X;
+				const double py = aPods[j].Y - aPods[i].Y;
+				const double vx = aPods[j].VX - aPods[i].VX;
+				const double vy = aPods[j].VY - aPods[i].VY;
+				const double a = vx * vx + vy * vy;
+				const double b = px * vx + py * vy;
+				const double c = px * px + py * py - 4.0 * Simulator::PodRadius * Simulator::PodRadius;
+				if (b >= 0.0 || a == 0.0)
+					continue;
+
+				double time = 0.0;
+				if (c > 0.0)
+				{
+					const double discriminant = b * b - a * c;
+					if (discriminant < 0.0)
+						continue;
+					time = (-b - std::sqrt(discriminant)) / a;
+				}
+				if (time < firstTime)
+				{
+					firstTime = time;
+					firstPodA = i;
+					firstPodB = j;
+				}
+			}
+		}
+
+		for (int i = 0; i < aPodCount; i++)
+		{
+			Move(aPods[i], firstTime);
+		}
+		remainingTime -= firstTime;
+
+		if (firstPodA < 0)
+			break;
+
+		ReferencePod& podA = aPods[firstPodA];
+		ReferencePod& podB = aPods[firstPodB];
+		const double massA = podA.Shielded ? Simulator::ShieldMass : 1.0;
+		const double massB = podB.Shielded ? Simulator::ShieldMass : 1.0;
+		const double massCoefficient = (massA + massB) / (massA * massB);
+		const double nx = podA.X - podB.X;
+		const double ny = podA.Y - podB.Y;
+		const double product = nx * (podA.VX - podB.VX) + ny * (podA.VY - podB.VY);
+		double fx = (nx * product) / ((nx * nx + ny * ny) * massCoefficient);
+		double fy = (ny * product) / ((nx * nx + ny * ny) * massCoefficient);
+		for (int impulse = 0; impulse < 2; impulse++)
+		{
+			podA.VX -= fx / massA;
+			podA.VY -= fy / massA;
+			podB.VX += fx / massB;
+			podB.VY += fy / massB;
+
+			const double magnitude = std::sqrt(fx * fx + fy * fy);
+			if (magnitude > 0.0 && magnitude < Simulator::MinImpulse)
+			{
+				fx = fx * Simulator::MinImpulse / magnitude;
+				fy = fy * Simulator::MinImpulse / magnitude;
+			}
+		}
+
+		collisions++;
+		lastPodA = firstPodA;
+		lastPodB = firstPodB;
+	}
+
+	for (int i = 0; i < aPodCount; i++)
+	{
+		ReferencePod& pod = aPods[i];
+		pod.X = std::floor(pod.X + 0.5);
+		pod.Y = std::floor(pod.Y + 0.5);
+		pod.VX = std::trunc(pod.VX * Simulator::FrictionPercent / 100.0);
+		pod.VY = std::trunc(pod.VY * Simulator::FrictionPercent / 100.0);
+	}
+	return collisions;
 }
 
-inline bool InterceptorPodStrategy::ShouldUseShield(Pod& pod, const SimulationEntry& aSimulationEntry)
+int RunSimulatorCheck()
 {
-	Pod& otherPod = (aSimulationEntry.myPods[0].IsRacer()) ? (aSimulationEntry.myPods[0]) : (aSimulationEntry.myPods[1]);
-	Pod& opponentPod1 = aSimulationEntry.opponentPods[0];
-	Pod& opponentPod2 = aSimulationEntry.opponentPods[1];
+	Random random(1);
+	const auto randomMove = [&random](const Simulator& aSimulator, const PodState& aPod)
+	{
+		// Mostly racing toward the next checkpoint so that games look like real ones, with every special move on some turns
+		PodMove move;
+		move.Rotation = (random.Range(0, 3) != 0)
+			? aSimulator.StraightMove(aPod).Rotation
+			: static_cast<int16_t>(random.Range(-Simulator::MaxRotation, Simulator::MaxRotation));
+		const int roll = random.Range(0, 99);
+		move.Thrust = (roll < 2) ? (PodMove::Boost) : ((roll < 5) ? (PodMove::Shield) : static_cast<int16_t>(random.Range(0, Simulator::MaxThrust)));
+		return move;
+	};
+
+	// -- Long games played by both simulators, the fixed-point one restarting from the referee state after each divergence
+	int64_t turns = 0;
+	int64_t collisionTurns = 0;
+	int64_t diverged = 0;
+	int64_t divergedOnCollision = 0;
+	for (int game = 0; game < ReferenceSimulator::CheckGames; game++)
+	{
+		int laps;
+		std::vector<Vector2<int>> checkpoints;
+		MapCorpus::Map(game % MapCorpus::Size, checkpoints, laps);
+		CheckpointManager checkpointManager;
+		checkpointManager.Build(checkpoints);
+		const Simulator simulator(checkpointManager);
+		const ReferenceSimulator reference(simulator);
+
+		GameState state = LocalReferee::StartState(simulator);
+		ReferenceSimulator::ReferencePod referencePods[4];
+		for (int i = 0; i < 4; i++)
+		{
+			referencePods[i] = ReferenceSimulator::FromState(state.Pods[i]);
+		}
 
-	if (Collision(pod, otherPod))
+		for (int turn = 0; turn < ReferenceSimulator::CheckTurns; turn++)
+		{
+			PodMove moves[4];
+			for (int i = 0; i < 4; i++)
+			{
+				moves[i] = randomMove(simulator, state.Pods[i]);
+			}
+			simulator.PlayTurn(state.Pods, moves, 4);
+			const int collisions = reference.PlayTurn(referencePods, moves, 4);
+			turns++;
+			collisionTurns += (collisions > 0);
+
+			bool same = true;
+			for (int i = 0; i < 4; i++)
+			{
+				same = same && ReferenceSimulator::Matches(referencePods[i], state.Pods[i]);
+			}
+			if (same == false)
+			{
+				diverged++;
+				divergedOnCollision += (collisions > 0);
+				for (int i = 0; i < 4; i++)
+				{
+					PodState& pod = state.Pods[i];
+					pod.X = static_cast<int16_t>(referencePods[i].X);
+					pod.Y = static_cast<int16_t>(referencePods[i].Y);
+					pod.VX = static_cast<int16_t>(referencePods[i].VX);
+					pod.VY = static_cast<int16_t>(referencePods[i].VY);
+					pod.NextCheckpointIndex = static_cast<uint8_t>(referencePods[i].NextCheckpointIndex);
+					pod.CheckpointsPassed = static_cast<uint16_t>(referencePods[i].CheckpointsPassed);
+				}
+			}
+		}
+	}
+
+	// -- Rollouts of both simulators from the same start with the same moves, as a search would play them
+	std::vector<Vector2<int>> checkpoints;
+	int laps;
+	MapCorpus::Map(0, checkpoints, laps);
+	CheckpointManager checkpointManager;
+	checkpointManager.Build(checkpoints);
+	const Simulator simulator(checkpointManager);
+	const ReferenceSimulator reference(simulator);
+	const GameState start = LocalReferee::StartState(simulator);
+	ReferenceSimulator::ReferencePod referenceStart[4];
+	for (int i = 0; i < 4; i++)
 	{
-		if (BeneficialCollision(pod, otherPod))
-			return false;
+		referenceStart[i] = ReferenceSimulator::FromState(start.Pods[i]);
+	}
 
-		return true;
+	constexpr int sequences = 1024;
+	std::vector<PodMove> moves(sequences * ReferenceSimulator::BenchmarkDepth * 4);
+	for (PodMove& move : moves)
+	{
+		move = randomMove(simulator, start.Pods[0]);
 	}
 
-	if (Collision(pod, opponentPod1))
+	int64_t checksum = 0;
+	const auto fixedStart = std::chrono::steady_clock::now();
+	for (int rollout = 0; rollout < ReferenceSimulator::BenchmarkRollouts; rollout++)
 	{
-		if (BeneficialCollision(pod, opponentPod1))
-			return true;
+		GameState state = start;
+		const PodMove* sequence = &moves[(rollout % sequences) * ReferenceSimulator::BenchmarkDepth * 4];
+		for (int depth = 0; depth < ReferenceSimulator::BenchmarkDepth; depth++)
+		{
+			simulator.PlayTurn(state, sequence + 4 * depth);
+		}
+		checksum += state.Pods[0].X;
+	}
+	const auto referenceStartTime = std::chrono::steady_clock::now();
+	for (int rollout = 0; rollout < ReferenceSimulator::BenchmarkRollouts; rollout++)
+	{
+		ReferenceSimulator::ReferencePod pods[4];
+		std::copy(referenceStart, referenceStart + 4, pods);
+		const PodMove* sequence = &moves[(rollout % sequences) * ReferenceSimulator::BenchmarkDepth * 4];
+		for (int depth = 0; depth < ReferenceSimulator::BenchmarkDepth; depth++)
+		{
+			reference.PlayTurn(pods, sequence + 4 * depth, 4);
+		}
+		checksum -= static_cast<int64_t>(pods[0].X);
+	}
+	const auto end = std::chrono::steady_clock::now();
+
+	const double fixedSeconds = std::chrono::duration<double>(referenceStartTime - fixedStart).count();
+	const double referenceSeconds = std::chrono::duration<double>(end - referenceStartTime).count();
+	std::cout << "Maps : corpus v" << MapCorpus::Version << ", " << ReferenceSimulator::CheckGames << " games of "
+		<< ReferenceSimulator::CheckTurns << " turns\n";
+	std::cout << "Turns " << turns << ", with a collision " << collisionTurns << "\n";
+	std::cout << "Diverged " << diverged << " (" << 100.0 * diverged / std::max<int64_t>(1, turns) << "%), on a collision "
+		<< divergedOnCollision << "\n";
+	std::cout << "Rollouts of depth " << ReferenceSimulator::BenchmarkDepth << " per second : fixed-point "
+		<< std::lround(ReferenceSimulator::BenchmarkRollouts / fixedSeconds) << ", double "
+		<< std::lround(ReferenceSimulator::BenchmarkRollouts / referenceSeconds) << " (checksum " << checksum << ")" << std::endl;
+	return 0;
+}
 
-		return false;
+// ==== State Search Benchmark ====
+
+inline void StateSearchBenchmark::BranchMoves(const GameState& aState, int aBranch, PodMove* aMoves) const
+{
+	static const int16_t rotations[3] = { -Simulator::MaxRotation, 0, Simulator::MaxRotation };
+	aMoves[0] = PodMove{ rotations[aBranch % 3], Simulator::MaxThrust };
+	aMoves[1] = PodMove{ rotations[aBranch / 3], Simulator::MaxThrust };
+	aMoves[2] = _mSimulator.StraightMove(aState.Pods[2]);
+	aMoves[3] = _mSimulator.StraightMove(aState.Pods[3]);
+}
+
+inline int64_t StateSearchBenchmark::Evaluate(const GameState& aState) const
+{
+	int64_t score = 0;
+	for (int i = 0; i < 2; i++)
+	{
+		const PodState& pod = aState.Pods[i];
+		const Vector2<int>& checkpoint = _mSimulator.CheckpointPosition(pod.NextCheckpointIndex);
+		const int64_t dx = checkpoint.X - pod.X;
+		const int64_t dy = checkpoint.Y - pod.Y;
+		score += int64_t(pod.CheckpointsPassed) * 100000000 - (dx * dx + dy * dy) / 1000;
 	}
+	return score;
+}
 
-	if (Collision(pod, opponentPod2))
+inline void StateSearchBenchmark::Apply(GameState& aState, const PodMove* aMoves)
+{
+	UndoEntry& entry = _mUndoLog[_mUndoDepth++];
+	std::copy(aState.Pods, aState.Pods + 4, entry.Pods);
+	entry.TimeLeft[0] = aState.TimeLeft[0];
+	entry.TimeLeft[1] = aState.TimeLeft[1];
+	entry.Turn = aState.Turn;
+
+	_mSimulator.PlayTurn(aState, aMoves);
+}
+
+inline void StateSearchBenchmark::Undo(GameState& aState)
+{
+	const UndoEntry& entry = _mUndoLog[--_mUndoDepth];
+	std::copy(entry.Pods, entry.Pods + 4, aState.Pods);
+	aState.TimeLeft[0] = entry.TimeLeft[0];
+	aState.TimeLeft[1] = entry.TimeLeft[1];
+	aState.Turn = entry.Turn;
+}
+
+inline int64_t StateSearchBenchmark::CopySearch(const GameState& aState, int aDepth)
+{
+	if (aDepth == 0)
+		return Evaluate(aState);
+
+	int64_t best = std::numeric_limits<int64_t>::min();
+	for (int branch = 0; branch < Branches; branch++)
 	{
-		if (BeneficialCollision(pod, opponentPod2))
-			return true;
+		PodMove moves[4];
+		BranchMoves(aState, branch, moves);
+		GameState child = aState;
+		_mSimulator.PlayTurn(child, moves);
+		_mNodes++;
+		best = std::max(best, CopySearch(child, aDepth - 1));
+	}
+	return best;
+}
 
-		return false;
+inline int64_t StateSearchBenchmark::UndoSearch(GameState& aState, int aDepth)
+{
+	// The log holds Depth turns, the search stops there whatever aDepth
+	if (aDepth == 0 || _mUndoDepth == Depth)
+		return Evaluate(aState);
+
+	int64_t best = std::numeric_limits<int64_t>::min();
+	for (int branch = 0; branch < Branches; branch++)
+	{
+		PodMove moves[4];
+		BranchMoves(aState, branch, moves);
+		Apply(aState, moves);
+		_mNodes++;
+		best = std::max(best, UndoSearch(aState, aDepth - 1));
+		Undo(aState);
 	}
+	return best;
+}
 
-	return false;
+int RunStateBenchmark()
+{
+	int laps;
+	std::vector<Vector2<int>> checkpoints;
+	MapCorpus::Map(0, checkpoints, laps);
+	CheckpointManager checkpointManager;
+	checkpointManager.Build(checkpoints);
+	const Simulator simulator(checkpointManager);
+	const GameState start = LocalReferee::StartState(simulator);
+
+	std::cout << "Depth " << StateSearchBenchmark::Depth << ", " << StateSearchBenchmark::Branches << " moves per turn, from the start of corpus v"
+		<< MapCorpus::Version << " map 0, best of " << StateSearchBenchmark::Repetitions << " runs\n";
+
+	float bestTimes[2] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+	int64_t scores[2] = {};
+	long long nodes = 0;
+	for (int repetition = 0; repetition < StateSearchBenchmark::Repetitions; repetition++)
+	{
+		for (int method = 0; method < 2; method++)
+		{
+			StateSearchBenchmark benchmark(simulator);
+			GameState state = start;
+			const auto begin = std::chrono::steady_clock::now();
+			scores[method] = (method == 0)
+				? (benchmark.CopySearch(state, StateSearchBenchmark::Depth))
+				: (benchmark.UndoSearch(state, StateSearchBenchmark::Depth));
+			const float elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - begin).count();
+			bestTimes[method] = std::min(bestTimes[method], elapsed);
+			nodes = benchmark.Nodes();
+		}
+	}
+
+	const char* names[2] = { "Copy per node", "Apply / undo " };
+	for (int method = 0; method < 2; method++)
+	{
+		std::cout << names[method] << " : " << nodes << " nodes in " << bestTimes[method] << "ms ("
+			<< std::lround(nodes / std::max(1e-3f, bestTimes[method])) << " nodes/ms), best score " << scores[method] << "\n";
+	}
+	std::cout << ((scores[0] == scores[1]) ? "Same best score" : "Best scores differ") << std::endl;
+	return (scores[0] == scores[1]) ? 0 : 1;
 }
 
-inline SimulationResult InterceptorPodStrategy::Compute(Pod& pod, const SimulationEntry& aSimulationEntry)
+// ==== Search Scaling ====
+
+int RunSearchScaling(int aMaxThreads)
 {
-	pod.SetTarget(ComputeTarget(pod, aSimulationEntry));
-	ComputeThrust(pod, aSimulationEntry);
-	return SimulationResult(pod.BoostUsed(), pod.ShieldUsed(), pod.Target().X, pod.Target().Y, pod.Thrust());
+	constexpr int positions = 20;
+	constexpr int warmupTurns = 30;
+	const int budget = TurnScheduler::NextTurnsBudget - TurnScheduler::DefaultSafetyMargin;
+
+	// -- Fixed positions : corpus maps raced straight to the checkpoints for a few turns, so pods are spread and moving
+	std::vector<std::vector<Vector2<int>>> maps(positions);
+	std::vector<int> laps(positions);
+	std::vector<GameState> states(positions);
+	for (int i = 0; i < positions; i++)
+	{
+		MapCorpus::Map(i, maps[i], laps[i]);
+		CheckpointManager checkpointManager;
+		checkpointManager.Build(maps[i]);
+		const Simulator simulator(checkpointManager);
+		states[i] = LocalReferee::StartState(simulator);
+		for (int turn = 0; turn < warmupTurns; turn++)
+		{
+			PodMove moves[4];
+			for (int pod = 0; pod < 4; pod++)
+			{
+				moves[pod] = simulator.StraightMove(states[i].Pods[pod]);
+			}
+			simulator.PlayTurn(states[i], moves);
+		}
+	}
+
+	std::cout << "Positions : " << positions << " on corpus v" << MapCorpus::Version << ", " << budget << "ms per turn\n";
+	double singleThreadCandidates = 0.0;
+	for (int threads = 1; threads <= std::max(1, aMaxThreads); threads++)
+	{
+		long long candidates = 0;
+		double score = 0.0;
+		for (int i = 0; i < positions; i++)
+		{
+			CheckpointManager checkpointManager;
+			checkpointManager.Build(maps[i]);
+			const Simulator simulator(checkpointManager);
+			ParallelSearchEngine engine(threads);
+
+			TurnContext context;
+			context.State = states[i];
+			context.TurnSimulator = &simulator;
+			context.Laps = laps[i];
+
+			const auto start = std::chrono::steady_clock::now();
+			const TurnDeadline deadline(start, start + std::chrono::milliseconds(budget));
+			TurnAnswer answer;
+			engine.Search(context, deadline, answer);
+			candidates += engine.Candidates();
+			score += answer.Score();
+		}
+
+		const double candidatesPerTurn = static_cast<double>(candidates) / positions;
+		singleThreadCandidates = (threads == 1) ? (candidatesPerTurn) : (singleThreadCandidates);
+		std::cout << threads << " threads : " << std::lround(candidatesPerTurn) << " candidates per turn (x"
+			<< candidatesPerTurn / std::max(1.0, singleThreadCandidates) << "), best score avg " << score / positions << std::endl;
+	}
+	return 0;
 }
 
 // ===================================
@@ -815,14 +4288,9 @@ inline SimulationResult InterceptorPodStrategy::Compute(Pod& pod, const Simulati
 // Return positive value if first pod is ahead of second pod, negative otherwise
 int IndexPodAhead(const Pod& firstPod, const Pod& secondPod, const CheckpointManager& aCheckpointManager)
 {
-	if (firstPod.CurrentLap() != secondPod.CurrentLap())
+	if (firstPod.CheckpointsPassed() != secondPod.CheckpointsPassed())
 	{
-		return firstPod.CurrentLap() > secondPod.CurrentLap();
-	}
-
-	if (firstPod.NextCheckpointIndex() != secondPod.NextCheckpointIndex())
-	{
-		return firstPod.NextCheckpointIndex() > secondPod.NextCheckpointIndex();
+		return firstPod.CheckpointsPassed() > secondPod.CheckpointsPassed();
 	}
 
 	size_t indexCheckpointFirstPod = firstPod.NextCheckpointIndex();
@@ -830,23 +4298,64 @@ int IndexPodAhead(const Pod& firstPod, const Pod& secondPod, const CheckpointMan
 	return firstPod.Position().DistanceSqr(positionNextCheckpoint) < secondPod.Position().DistanceSqr(positionNextCheckpoint);
 }
 
-int main()
+/**
+* Options of the bot itself, so that local comparisons can pit configurations against each other
+*/
+struct BotConfiguration
+{
+	// The search engine stays opt-in until a --sprt run against the heuristic strategies justifies making it the default
+	std::string Engine = "heuristic";
+	std::string Racer = "heuristic";
+	bool Ponder = std::thread::hardware_concurrency() > 1;
+	int SearchThreads = 1;
+	int DeterministicCandidates = 0;
+	int BeamWidth = BeamSearchRacer::DefaultWidth;
+	int SafetyMargin = TurnScheduler::DefaultSafetyMargin;
+	int TurnBudget = TurnScheduler::NextTurnsBudget;
+};
+
+int RunBot(const BotConfiguration& aConfiguration)
 {
 	CheckpointManager checkpointsManager;
 	std::vector<Pod> myPods(2);
 	std::vector<Pod> opponentPods(2);
 
-	RacerPodStrategy racerStrategy;
+	RacerLookupTable racerTable;
+	BeamSearchRacer beamSearch(aConfiguration.BeamWidth);
+	RacerPodStrategy heuristicRacerStrategy;
+	LookupRacerPodStrategy lookupRacerStrategy(racerTable);
+	BeamRacerPodStrategy beamRacerStrategy(beamSearch);
+	RacerPodStrategy& racerStrategy = (aConfiguration.Racer == "lookup") ? (lookupRacerStrategy)
+		: (aConfiguration.Racer == "beam") ? (beamRacerStrategy) : (heuristicRacerStrategy);
 	InterceptorPodStrategy interceptorStrategy;
 
+	TurnScheduler scheduler(aConfiguration.SafetyMargin, aConfiguration.TurnBudget);
+	ParallelSearchEngine monteCarloEngine(aConfiguration.SearchThreads, aConfiguration.DeterministicCandidates);
+	TurnEngine* searchEngine = (aConfiguration.Engine == "montecarlo") ? (&monteCarloEngine) : (nullptr);
+	Ponderer ponderer;
+
 	// Variables holding input
 	size_t laps;
 
-	// Lap count & initializing checkpoint manager from input
+	// Lap count & initializing checkpoint manager from input, the first turn clock starts with it
+	if (scheduler.WaitForInput() == false)
+		return 0;
 	std::cin >> laps; std::cin.ignore();
 	checkpointsManager.BuildFromStandardInput();
 
-	while (1) {
+	// The table doesn't depend on the map, the first turn leaves plenty of time to build it
+	if (aConfiguration.Racer == "lookup")
+	{
+		racerTable.Build();
+	}
+
+	const Simulator simulator(checkpointsManager);
+	WorldEstimator worldEstimator(simulator);
+
+	while (scheduler.WaitForInput()) {
+
+		// -- The engine comes back from pondering as soon as the turn starts
+		ponderer.Stop();
 
 		// -- Our pods and opponent update from standard entry
 		for (Pod& pod : myPods)
@@ -859,6 +4368,8 @@ int main()
 			opponentPod.UpdateFromStandardInput();
 		}
 
+		worldEstimator.Update(myPods, opponentPods);
+
 		int indexRacingPod = (IndexPodAhead(myPods[0], myPods[1], checkpointsManager)) ? (0) : (1);
 		int indexOpponentAhead = (IndexPodAhead(opponentPods[0], opponentPods[1], checkpointsManager)) ? (0) : (1);
 		Pod& racingPod = myPods[indexRacingPod];
@@ -871,9 +4382,148 @@ int main()
 
 		SimulationEntry entry{ myPods, opponentPods, checkpointsManager, indexOpponentAhead };
 
+		TurnContext context;
+		worldEstimator.FillContext(context);
+		context.Laps = static_cast<int>(laps);
+
+		ponderer.Report(context);
+
+		// -- Searching until the deadline, strategies answer if the engine could not
+		TurnAnswer answer;
+		const TurnDeadline deadline = scheduler.Deadline();
+		beamRacerStrategy.SetDeadline(&deadline);
+		scheduler.Play(searchEngine, context, answer);
+		if (searchEngine == &monteCarloEngine)
+		{
+			std::cerr << "Search : " << monteCarloEngine.Candidates() << " candidates on " << monteCarloEngine.Threads() << " threads" << std::endl;
+		}
+
 		// ============================ 
-		std::cout << racingPod.Compute(entry) << std::endl;
-		std::cout << interceptorPod.Compute(entry) << std::endl;
+		// The referee expects one line per pod, in input order
+		for (int i = 0; i < 2; i++)
+		{
+			if (answer.Available())
+				std::cout << myPods[i].Output(context.State.Pods[i], answer.Move(i)) << std::endl;
+			else
+				std::cout << myPods[i].Compute(entry) << std::endl;
+		}
+		const PodMove firstPodMove = myPods[0].LastMove(context.State.Pods[0]);
+		const PodMove secondPodMove = myPods[1].LastMove(context.State.Pods[1]);
+		worldEstimator.RecordMoves(firstPodMove, secondPodMove);
+
+		scheduler.EndTurn(answer.Available());
+
+		// Pondering depends on how long the opponent thinks, which a deterministic search can't
+		if (aConfiguration.Ponder && aConfiguration.DeterministicCandidates == 0)
+		{
+			ponderer.Start(searchEngine, context, firstPodMove, secondPodMove);
+		}
+	}
+
+	return 0;
+}
+
+const char* Usage =
+	"Usage :\n"
+	"  bot [--engine heuristic|montecarlo] [--racer heuristic|lookup|beam] [--ponder on|off] [--margin ms] [--turn-budget ms]\n"
+	"      [--search-threads n] [--deterministic candidates] [--beam-width n]\n"
+	"      Play on standard input and output, as on the game platform\n"
+	"      The racer only plays the turns the engine gives no answer, which means all of them with the default heuristic engine\n"
+	"  bot --sprt <command A> <command B> [--elo0 e] [--elo1 e] [--alpha a] [--beta b] [--games n] [--threads n] [--first-map n]\n"
+	"      [--time-tolerance ms]\n"
+	"      Play bot commands A and B against each other on the map corpus until the test decides if B is elo1 better\n"
+	"      A bot answering later than the platform turn budgets plus the tolerance loses the game\n"
+	"  bot --corpus\n"
+	"      Describe the map corpus used by comparisons and benchmarks\n"
+	"  bot --check-simulator\n"
+	"      Count the turns where the fixed-point simulator differs from the referee arithmetic, and compare their speed\n"
+	"  bot --state-benchmark\n"
+	"      Time a depth-first search copying the game state per node against applying and undoing turns on one state\n"
+	"  bot --search-scaling <threads>\n"
+	"      Search the same positions with 1 to <threads> search threads, to measure how the search scales\n";
+
+int main(int argc, char** argv)
+{
+	BotConfiguration configuration;
+	SprtConfiguration comparison;
+	comparison.Threads = std::max(1u, std::thread::hardware_concurrency() / 2);
+	bool compare = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string option = argv[i];
+		const bool hasValue = (i + 1 < argc);
+
+		if (option == "--sprt" && i + 2 < argc)
+		{
+			compare = true;
+			comparison.CommandA = argv[++i];
+			comparison.CommandB = argv[++i];
+		}
+		else if (option == "--engine" && hasValue)
+			configuration.Engine = argv[++i];
+		else if (option == "--racer" && hasValue)
+			configuration.Racer = argv[++i];
+		else if (option == "--ponder" && hasValue)
+			configuration.Ponder = (std::string(argv[++i]) != "off");
+		else if (option == "--beam-width" && hasValue)
+			configuration.BeamWidth = std::atoi(argv[++i]);
+		else if (option == "--search-threads" && hasValue)
+			configuration.SearchThreads = std::atoi(argv[++i]);
+		else if (option == "--deterministic" && hasValue)
+			configuration.DeterministicCandidates = std::atoi(argv[++i]);
+		else if (option == "--margin" && hasValue)
+			configuration.SafetyMargin = std::atoi(argv[++i]);
+		else if (option == "--turn-budget" && hasValue)
+			configuration.TurnBudget = std::atoi(argv[++i]);
+		else if (option == "--elo0" && hasValue)
+			comparison.Elo0 = std::atof(argv[++i]);
+		else if (option == "--elo1" && hasValue)
+			comparison.Elo1 = std::atof(argv[++i]);
+		else if (option == "--alpha" && hasValue)
+			comparison.Alpha = std::atof(argv[++i]);
+		else if (option == "--beta" && hasValue)
+			comparison.Beta = std::atof(argv[++i]);
+		else if (option == "--games" && hasValue)
+			comparison.MaxGames = std::atoi(argv[++i]);
+		else if (option == "--threads" && hasValue)
+			comparison.Threads = std::atoi(argv[++i]);
+		else if (option == "--first-map" && hasValue)
+			comparison.FirstMap = std::max(0, std::atoi(argv[++i]));
+		else if (option == "--time-tolerance" && hasValue)
+			comparison.TimeTolerance = std::max(0, std::atoi(argv[++i]));
+		else if (option == "--corpus")
+		{
+			MapCorpus::Report(std::cout);
+			return 0;
+		}
+		else if (option == "--check-simulator")
+		{
+			return RunSimulatorCheck();
+		}
+		else if (option == "--state-benchmark")
+		{
+			return RunStateBenchmark();
+		}
+		else if (option == "--search-scaling" && hasValue)
+		{
+			return RunSearchScaling(std::atoi(argv[++i]));
+		}
+		else
+		{
+			std::cerr << Usage;
+			return 1;
+		}
+	}
 
+	if (compare)
+		return RunSprt(comparison);
+
+	if (configuration.Engine == "montecarlo" && configuration.Racer != "heuristic")
+	{
+		std::cerr << "Warning : the " << configuration.Racer << " racer only plays the turns the montecarlo engine gives no answer,"
+			<< " use --engine heuristic to race with it" << std::endl;
 	}
-}
\ No newline at end of file
+
+	return RunBot(configuration);
+}